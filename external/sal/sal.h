@@ -0,0 +1,52 @@
+#pragma once
+
+// Empty stand-ins for the source annotations DirectXMath uses, for platforms without the Windows SDK's sal.h. They
+// only inform static analysis, so defining them away does not change any code.
+#ifndef _In_
+#define _In_
+#endif
+#ifndef _In_opt_
+#define _In_opt_
+#endif
+#ifndef _In_reads_
+#define _In_reads_(size)
+#endif
+#ifndef _In_reads_bytes_
+#define _In_reads_bytes_(size)
+#endif
+#ifndef _Out_
+#define _Out_
+#endif
+#ifndef _Out_opt_
+#define _Out_opt_
+#endif
+#ifndef _Out_writes_
+#define _Out_writes_(size)
+#endif
+#ifndef _Out_writes_bytes_
+#define _Out_writes_bytes_(size)
+#endif
+#ifndef _Inout_
+#define _Inout_
+#endif
+#ifndef _Inout_updates_
+#define _Inout_updates_(size)
+#endif
+#ifndef _Inout_updates_bytes_
+#define _Inout_updates_bytes_(size)
+#endif
+#ifndef _Outptr_
+#define _Outptr_
+#endif
+#ifndef _Success_
+#define _Success_(expression)
+#endif
+#ifndef _Check_return_
+#define _Check_return_
+#endif
+#ifndef _Use_decl_annotations_
+#define _Use_decl_annotations_
+#endif
+#ifndef _Analysis_assume_
+#define _Analysis_assume_(expression)
+#endif
\ No newline at end of file
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <initializer_list>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace BenchmarkUtil
+{
+    struct Result
+    {
+        double minMilliseconds;
+        double medianMilliseconds;
+        size_t iterationCount;
+    };
+
+    // runs func repeatedly until at least minIterations runs and minTotalSeconds have passed
+    template <typename Func>
+    Result measure(Func&& func, const size_t minIterations = 5u, const double minTotalSeconds = 0.5)
+    {
+        using clock_type = std::chrono::steady_clock;
+
+        std::vector<double> milliseconds;
+        double totalSeconds = 0.0;
+        while (milliseconds.size() < minIterations || totalSeconds < minTotalSeconds)
+        {
+            const clock_type::time_point start = clock_type::now();
+            func();
+            const clock_type::duration duration = clock_type::now() - start;
+            milliseconds.push_back(std::chrono::duration<double, std::milli>(duration).count());
+            totalSeconds += std::chrono::duration<double>(duration).count();
+        }
+
+        std::sort(milliseconds.begin(), milliseconds.end());
+        return { milliseconds.front(), milliseconds[milliseconds.size() / 2], milliseconds.size() };
+    }
+
+    // Collects results to write them as JSON, so runs can be compared with each other by scripts. Names identify a
+    // configuration and should stay stable between runs, e.g. "createSquare/side:1024/index:32/writer:static".
+    // Counters hold values besides the timings, like throughputs or speedups.
+    class Report
+    {
+    public:
+        void addContext(const char* const name, const double value)
+        {
+            m_context.emplace_back(name, value);
+        }
+
+        void add(std::string name, const Result& result, const std::initializer_list<std::pair<const char*, double>> counters = {})
+        {
+            m_entries.push_back({ std::move(name), result, std::vector<std::pair<std::string, double>>(counters.begin(), counters.end()) });
+        }
+
+        bool writeJson(const char* const path) const
+        {
+            std::FILE* const pFile = std::fopen(path, "w");
+            if (pFile == nullptr)
+            {
+                return false;
+            }
+
+            std::fprintf(pFile, "{\n    \"context\": {");
+            writeValues(pFile, m_context);
+            std::fprintf(pFile, "},\n    \"benchmarks\": [");
+            for (size_t entryIndex = 0; entryIndex < m_entries.size(); ++entryIndex)
+            {
+                const Entry& entry = m_entries[entryIndex];
+                std::fprintf(pFile, "%s\n        {\"name\": ", entryIndex > 0u ? "," : "");
+                writeString(pFile, entry.name);
+                std::fprintf(pFile, ", \"minMilliseconds\": ");
+                writeNumber(pFile, entry.result.minMilliseconds);
+                std::fprintf(pFile, ", \"medianMilliseconds\": ");
+                writeNumber(pFile, entry.result.medianMilliseconds);
+                std::fprintf(pFile, ", \"iterationCount\": %zu, \"counters\": {", entry.result.iterationCount);
+                writeValues(pFile, entry.counters);
+                std::fprintf(pFile, "}}");
+            }
+            std::fprintf(pFile, "\n    ]\n}\n");
+            return std::fclose(pFile) == 0;
+        }
+
+    private:
+        struct Entry
+        {
+            std::string name;
+            Result result;
+            std::vector<std::pair<std::string, double>> counters;
+        };
+
+        static void writeString(std::FILE* const pFile, const std::string& string)
+        {
+            std::fputc('"', pFile);
+            for (const char character : string)
+            {
+                if (character == '"' || character == '\\')
+                {
+                    std::fputc('\\', pFile);
+                }
+                std::fputc(character, pFile);
+            }
+            std::fputc('"', pFile);
+        }
+
+        // JSON has no infinities or NaNs
+        static void writeNumber(std::FILE* const pFile, const double value)
+        {
+            if (std::isfinite(value))
+            {
+                std::fprintf(pFile, "%.9g", value);
+            }
+            else
+            {
+                std::fprintf(pFile, "null");
+            }
+        }
+
+        static void writeValues(std::FILE* const pFile, const std::vector<std::pair<std::string, double>>& values)
+        {
+            for (size_t valueIndex = 0; valueIndex < values.size(); ++valueIndex)
+            {
+                std::fprintf(pFile, "%s", valueIndex > 0u ? ", " : "");
+                writeString(pFile, values[valueIndex].first);
+                std::fprintf(pFile, ": ");
+                writeNumber(pFile, values[valueIndex].second);
+            }
+        }
+
+        std::vector<std::pair<std::string, double>> m_context;
+        std::vector<Entry> m_entries;
+    };
+}
\ No newline at end of file
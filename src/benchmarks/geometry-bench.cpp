@@ -0,0 +1,983 @@
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BenchmarkUtil.h"
+#include "GeometryCacheUtil.h"
+#include "GeometryUtil.h"
+#include "MeshOptimizationUtil.h"
+#include "MeshletUtil.h"
+#include "MeshSimplificationUtil.h"
+#include "ThreadUtil.h"
+
+namespace
+{
+    constexpr GeometryUtil::VertexAttributeDesc quantizedAttributeCollection[] =
+    {
+        {GeometryUtil::VertexAttributeType::POSITION_UNORM16, 0u},
+        {GeometryUtil::VertexAttributeType::UV_HALF, 8u},
+        {GeometryUtil::VertexAttributeType::NORMAL_OCT_SNORM16, 12u},
+    };
+
+    // all benchmark meshes fit into the unit cube around the origin
+    constexpr GeometryUtil::VertexDesc quantizedVertexDesc = {
+        sizeof(quantizedAttributeCollection) / sizeof(GeometryUtil::VertexAttributeDesc), quantizedAttributeCollection, 16u,
+        { -1.0f, -1.0f, -1.0f }, { 1.0f, 1.0f, 1.0f }
+    };
+
+    // runtime and compile time writers of one layout, e.g. the runtime and static rows of "default"
+    template <const GeometryUtil::VertexDesc& vertexDesc, typename IndexType>
+    void benchmarkGeoSphereLayout(BenchmarkUtil::Report& report, const char* const layoutName, const uint8_t subdivisions)
+    {
+        size_t vertexCount;
+        size_t indexCount;
+        GeometryUtil::calculateVertexIndexCountsGeoSphere(subdivisions, vertexCount, indexCount);
+
+        std::unique_ptr<uint8_t[]> pVertices = std::make_unique<uint8_t[]>(vertexCount * vertexDesc.stride);
+        std::unique_ptr<IndexType[]> pIndices = std::make_unique<IndexType[]>(indexCount);
+        const unsigned indexBits = static_cast<unsigned>(sizeof(IndexType) * 8u);
+
+        const BenchmarkUtil::Result runtimeResult = BenchmarkUtil::measure([&]()
+        {
+            GeometryUtil::createGeoSphere(1.0f, subdivisions, pVertices.get(), pIndices.get(), vertexDesc);
+        });
+        std::printf("%12u %10zu %10zu %6u %10s %8s %12.4f %12.4f\n", subdivisions, vertexCount, indexCount, indexBits, layoutName, "runtime", runtimeResult.minMilliseconds, runtimeResult.medianMilliseconds);
+
+        const BenchmarkUtil::Result staticResult = BenchmarkUtil::measure([&]()
+        {
+            GeometryUtil::createGeoSphere<vertexDesc>(1.0f, subdivisions, pVertices.get(), pIndices.get());
+        });
+        std::printf("%12u %10zu %10zu %6u %10s %8s %12.4f %12.4f\n", subdivisions, vertexCount, indexCount, indexBits, layoutName, "static", staticResult.minMilliseconds, staticResult.medianMilliseconds);
+
+        const std::string name = "createGeoSphere/subdivisions:" + std::to_string(subdivisions) + "/index:" + std::to_string(indexBits) + "/layout:" + layoutName;
+        report.add(name + "/writer:runtime", runtimeResult, { { "vertices", static_cast<double>(vertexCount) } });
+        report.add(name + "/writer:static", staticResult, { { "vertices", static_cast<double>(vertexCount) } });
+    }
+
+    template <typename IndexType>
+    void benchmarkGeoSphereLevel(BenchmarkUtil::Report& report, const uint8_t subdivisions)
+    {
+        benchmarkGeoSphereLayout<GeometryUtil::defaultVertexDesc, IndexType>(report, "default", subdivisions);
+        benchmarkGeoSphereLayout<GeometryUtil::compactVertexDesc, IndexType>(report, "compact", subdivisions);
+        benchmarkGeoSphereLayout<quantizedVertexDesc, IndexType>(report, "quantized", subdivisions);
+    }
+
+    void benchmarkGeoSphere(BenchmarkUtil::Report& report)
+    {
+        std::printf("createGeoSphere\n");
+        std::printf("%12s %10s %10s %6s %10s %8s %12s %12s\n", "subdivisions", "vertices", "indices", "index", "layout", "writer", "min [ms]", "median [ms]");
+
+        // 16 bit indices can address at most 6 subdivisions, beyond that 32 bit indices are required
+        for (uint8_t subdivisions = 0u; subdivisions <= 6u; ++subdivisions)
+        {
+            benchmarkGeoSphereLevel<uint16_t>(report, subdivisions);
+        }
+        for (uint8_t subdivisions = 6u; subdivisions <= 7u; ++subdivisions)
+        {
+            benchmarkGeoSphereLevel<uint32_t>(report, subdivisions);
+        }
+    }
+
+    // distance in representable floats, 0 for equal values
+    uint32_t getUlpDistance(const float lhs, const float rhs)
+    {
+        const auto toOrdered = [](const float value)
+        {
+            int32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            return bits < 0 ? static_cast<int64_t>(INT32_MIN) - bits : static_cast<int64_t>(bits);
+        };
+        return static_cast<uint32_t>(std::min<int64_t>(std::abs(toOrdered(lhs) - toOrdered(rhs)), UINT32_MAX));
+    }
+
+    // Static writers of packed float layouts take createSquare's 4 wide path, runtime writers the scalar one. Returns
+    // the number of vertices the two disagree on by more than an ulp per float, other layouts have to match exactly.
+    template <const GeometryUtil::VertexDesc& vertexDesc>
+    size_t countMismatchedVertices(const uint8_t* const staticVertices, const uint8_t* const runtimeVertices, const size_t vertexCount)
+    {
+        if constexpr (!GeometryUtil::isPackedFloatVertexDesc(vertexDesc))
+        {
+            return std::memcmp(staticVertices, runtimeVertices, vertexCount * vertexDesc.stride) == 0 ? 0u : vertexCount;
+        }
+        else
+        {
+            constexpr uint32_t maxUlpDistance = 1u;
+            size_t mismatchedVertexCount = 0;
+            for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+            {
+                float staticFloats[vertexDesc.stride / sizeof(float)];
+                float runtimeFloats[vertexDesc.stride / sizeof(float)];
+                std::memcpy(staticFloats, staticVertices + vertex * vertexDesc.stride, vertexDesc.stride);
+                std::memcpy(runtimeFloats, runtimeVertices + vertex * vertexDesc.stride, vertexDesc.stride);
+                for (size_t i = 0; i < vertexDesc.stride / sizeof(float); ++i)
+                {
+                    if (getUlpDistance(staticFloats[i], runtimeFloats[i]) > maxUlpDistance)
+                    {
+                        ++mismatchedVertexCount;
+                        break;
+                    }
+                }
+            }
+            return mismatchedVertexCount;
+        }
+    }
+
+    // returns the number of vertices the static writer got wrong, see countMismatchedVertices
+    template <const GeometryUtil::VertexDesc& vertexDesc, typename IndexType>
+    size_t benchmarkSquareLayout(BenchmarkUtil::Report& report, const char* const layoutName, const uint32_t vertexCountPerSide)
+    {
+        size_t vertexCount;
+        size_t indexCount;
+        GeometryUtil::calculateVertexIndexCountsSquare(vertexCountPerSide, vertexCount, indexCount);
+
+        std::unique_ptr<uint8_t[]> pVertices = std::make_unique<uint8_t[]>(vertexCount * vertexDesc.stride);
+        std::unique_ptr<uint8_t[]> pRuntimeVertices = std::make_unique<uint8_t[]>(vertexCount * vertexDesc.stride);
+        std::unique_ptr<IndexType[]> pIndices = std::make_unique<IndexType[]>(indexCount);
+        const unsigned indexBits = static_cast<unsigned>(sizeof(IndexType) * 8u);
+
+        const BenchmarkUtil::Result runtimeResult = BenchmarkUtil::measure([&]()
+        {
+            GeometryUtil::createSquare(1.0f, vertexCountPerSide, pRuntimeVertices.get(), pIndices.get(), vertexDesc);
+        });
+        std::printf("%12u %10zu %10zu %6u %10s %8s %12.4f %12.4f\n", vertexCountPerSide, vertexCount, indexCount, indexBits, layoutName, "runtime", runtimeResult.minMilliseconds, runtimeResult.medianMilliseconds);
+
+        const BenchmarkUtil::Result staticResult = BenchmarkUtil::measure([&]()
+        {
+            GeometryUtil::createSquare<vertexDesc>(1.0f, vertexCountPerSide, pVertices.get(), pIndices.get());
+        });
+        std::printf("%12u %10zu %10zu %6u %10s %8s %12.4f %12.4f\n", vertexCountPerSide, vertexCount, indexCount, indexBits, layoutName, "static", staticResult.minMilliseconds, staticResult.medianMilliseconds);
+
+        const std::string name = "createSquare/side:" + std::to_string(vertexCountPerSide) + "/index:" + std::to_string(indexBits) + "/layout:" + layoutName;
+        report.add(name + "/writer:runtime", runtimeResult, { { "vertices", static_cast<double>(vertexCount) } });
+        report.add(name + "/writer:static", staticResult, { { "vertices", static_cast<double>(vertexCount) } });
+        return countMismatchedVertices<vertexDesc>(pVertices.get(), pRuntimeVertices.get(), vertexCount);
+    }
+
+    template <typename IndexType>
+    size_t benchmarkSquareSide(BenchmarkUtil::Report& report, const uint32_t vertexCountPerSide)
+    {
+        size_t mismatchedVertexCount = benchmarkSquareLayout<GeometryUtil::defaultVertexDesc, IndexType>(report, "default", vertexCountPerSide);
+        mismatchedVertexCount += benchmarkSquareLayout<GeometryUtil::compactVertexDesc, IndexType>(report, "compact", vertexCountPerSide);
+        mismatchedVertexCount += benchmarkSquareLayout<quantizedVertexDesc, IndexType>(report, "quantized", vertexCountPerSide);
+        return mismatchedVertexCount;
+    }
+
+    // returns the number of vertices the 4 wide path wrote differently from the scalar one, which has to be 0
+    size_t benchmarkSquare(BenchmarkUtil::Report& report)
+    {
+        std::printf("createSquare\n");
+        std::printf("%12s %10s %10s %6s %10s %8s %12s %12s\n", "side", "vertices", "indices", "index", "layout", "writer", "min [ms]", "median [ms]");
+
+        // 16 bit indices can address at most 256 vertices per side
+        size_t mismatchedVertexCount = 0;
+        constexpr uint32_t vertexCountsPerSide16[] = { 16u, 64u, 128u, 255u, 256u };
+        for (const uint32_t vertexCountPerSide : vertexCountsPerSide16)
+        {
+            mismatchedVertexCount += benchmarkSquareSide<uint16_t>(report, vertexCountPerSide);
+        }
+        constexpr uint32_t vertexCountsPerSide32[] = { 256u, 512u, 1024u };
+        for (const uint32_t vertexCountPerSide : vertexCountsPerSide32)
+        {
+            mismatchedVertexCount += benchmarkSquareSide<uint32_t>(report, vertexCountPerSide);
+        }
+        return mismatchedVertexCount;
+    }
+
+    // The count functions are constexpr and usually folded away, the volatile parameters keep them at runtime to show
+    // that calling them with runtime values stays negligible next to generating.
+    void benchmarkCounts(BenchmarkUtil::Report& report)
+    {
+        std::printf("vertex and index count functions, every valid parameter per iteration\n");
+        std::printf("%28s %10s %12s %12s\n", "function", "calls", "min [ms]", "ns/call");
+
+        constexpr size_t maxSubdivisions = 7u;
+        constexpr uint32_t maxVertexCountPerSide = 4096u;
+        volatile uint8_t subdivisionsEnd = static_cast<uint8_t>(maxSubdivisions + 1u);
+        volatile uint32_t vertexCountPerSideEnd = maxVertexCountPerSide + 1u;
+        size_t countSum = 0;
+
+        const auto reportCounts = [&report](const char* const function, const size_t callCount, const BenchmarkUtil::Result& result)
+        {
+            const double nanosecondsPerCall = result.minMilliseconds * 1.0e6 / static_cast<double>(callCount);
+            std::printf("%28s %10zu %12.6f %12.3f\n", function, callCount, result.minMilliseconds, nanosecondsPerCall);
+            report.add(std::string("counts/") + function, result, { { "nanosecondsPerCall", nanosecondsPerCall } });
+        };
+
+        const BenchmarkUtil::Result geoSphereResult = BenchmarkUtil::measure([&]()
+        {
+            for (uint8_t subdivisions = 0u; subdivisions < subdivisionsEnd; ++subdivisions)
+            {
+                size_t vertexCount;
+                size_t indexCount;
+                GeometryUtil::calculateVertexIndexCountsGeoSphere(subdivisions, vertexCount, indexCount);
+                countSum += vertexCount + indexCount;
+            }
+        });
+        reportCounts("GeoSphere", maxSubdivisions + 1u, geoSphereResult);
+
+        const BenchmarkUtil::Result lodChainResult = BenchmarkUtil::measure([&]()
+        {
+            for (uint8_t maxLodSubdivisions = 0u; maxLodSubdivisions < subdivisionsEnd; ++maxLodSubdivisions)
+            {
+                size_t vertexCount;
+                size_t indexCount;
+                GeometryUtil::calculateVertexIndexCountsGeoSphereLodChain(maxLodSubdivisions, vertexCount, indexCount);
+                countSum += vertexCount + indexCount;
+            }
+        });
+        reportCounts("GeoSphereLodChain", maxSubdivisions + 1u, lodChainResult);
+
+        const BenchmarkUtil::Result squareResult = BenchmarkUtil::measure([&]()
+        {
+            for (uint32_t vertexCountPerSide = 2u; vertexCountPerSide < vertexCountPerSideEnd; ++vertexCountPerSide)
+            {
+                size_t vertexCount;
+                size_t indexCount;
+                GeometryUtil::calculateVertexIndexCountsSquare(vertexCountPerSide, vertexCount, indexCount);
+                countSum += vertexCount + indexCount;
+            }
+        });
+        reportCounts("Square", maxVertexCountPerSide - 1u, squareResult);
+
+        // the sum keeps the loops from being removed
+        volatile size_t countSink = countSum;
+        (void)countSink;
+    }
+
+    void benchmarkThreadScaling(BenchmarkUtil::Report& report)
+    {
+        std::printf("createGeoSphere and createSquare thread scaling\n");
+        std::printf("%16s %10s %8s %12s %12s %8s\n", "mesh", "vertices", "threads", "min [ms]", "median [ms]", "speedup");
+
+        const size_t maxThreadCount = ThreadUtil::getDefaultThreadCount();
+        const auto benchmarkThreadCounts = [&](const char* const meshName, const size_t vertexCount, const auto& generate)
+        {
+            double singleThreadMedian = 0.0;
+            // powers of two up to the hardware thread count, which is always included
+            for (size_t threadCount = 1u; ; threadCount = std::min(threadCount * 2u, maxThreadCount))
+            {
+                const BenchmarkUtil::Result result = BenchmarkUtil::measure([&]()
+                {
+                    generate(threadCount);
+                });
+                if (threadCount == 1u)
+                {
+                    singleThreadMedian = result.medianMilliseconds;
+                }
+                const double speedup = singleThreadMedian / result.medianMilliseconds;
+                std::printf("%16s %10zu %8zu %12.4f %12.4f %8.2f\n", meshName, vertexCount, threadCount, result.minMilliseconds, result.medianMilliseconds, speedup);
+                report.add(std::string("threadScaling/") + meshName + "/threads:" + std::to_string(threadCount), result, { { "speedup", speedup } });
+
+                if (threadCount == maxThreadCount)
+                {
+                    break;
+                }
+            }
+        };
+
+        constexpr uint8_t subdivisionLevels[] = { 6u, 8u };
+        for (const uint8_t subdivisions : subdivisionLevels)
+        {
+            size_t vertexCount;
+            size_t indexCount;
+            GeometryUtil::calculateVertexIndexCountsGeoSphere(subdivisions, vertexCount, indexCount);
+
+            std::unique_ptr<uint8_t[]> pVertices = std::make_unique<uint8_t[]>(vertexCount * GeometryUtil::defaultVertexDesc.stride);
+            std::unique_ptr<uint32_t[]> pIndices = std::make_unique<uint32_t[]>(indexCount);
+
+            char meshName[32];
+            std::snprintf(meshName, sizeof(meshName), "geosphere %u", subdivisions);
+            benchmarkThreadCounts(meshName, vertexCount, [&](const size_t threadCount)
+            {
+                GeometryUtil::createGeoSphere<GeometryUtil::defaultVertexDesc>(1.0f, subdivisions, pVertices.get(), pIndices.get(), threadCount);
+            });
+        }
+
+        constexpr uint32_t vertexCountsPerSide[] = { 1024u, 4096u };
+        for (const uint32_t vertexCountPerSide : vertexCountsPerSide)
+        {
+            size_t vertexCount;
+            size_t indexCount;
+            GeometryUtil::calculateVertexIndexCountsSquare(vertexCountPerSide, vertexCount, indexCount);
+
+            std::unique_ptr<uint8_t[]> pVertices = std::make_unique<uint8_t[]>(vertexCount * GeometryUtil::defaultVertexDesc.stride);
+            std::unique_ptr<uint32_t[]> pIndices = std::make_unique<uint32_t[]>(indexCount);
+
+            char meshName[32];
+            std::snprintf(meshName, sizeof(meshName), "square %u", vertexCountPerSide);
+            benchmarkThreadCounts(meshName, vertexCount, [&](const size_t threadCount)
+            {
+                GeometryUtil::createSquare<GeometryUtil::defaultVertexDesc>(1.0f, vertexCountPerSide, pVertices.get(), pIndices.get(), threadCount);
+            });
+        }
+    }
+
+    template <typename IndexType>
+    void benchmarkVertexCacheOptimization(BenchmarkUtil::Report& report, const char* const meshName, const size_t vertexCount, const IndexType* const indices, const size_t indexCount)
+    {
+        const MeshOptimizationUtil::VertexCacheStatistics before = MeshOptimizationUtil::analyzeVertexCache(indices, indexCount, vertexCount);
+
+        std::unique_ptr<IndexType[]> pOptimizedIndices = std::make_unique<IndexType[]>(indexCount);
+        const BenchmarkUtil::Result result = BenchmarkUtil::measure([&]()
+        {
+            MeshOptimizationUtil::optimizeVertexCache(pOptimizedIndices.get(), indices, indexCount, vertexCount);
+        });
+        const MeshOptimizationUtil::VertexCacheStatistics after = MeshOptimizationUtil::analyzeVertexCache(pOptimizedIndices.get(), indexCount, vertexCount);
+
+        std::printf("%16s %10zu %8.3f %8.3f %8.3f %8.3f %12.4f\n", meshName, indexCount / 3u, before.acmr, after.acmr, before.atvr, after.atvr, result.medianMilliseconds);
+        report.add(std::string("optimizeVertexCache/") + meshName, result, { { "acmr", before.acmr }, { "acmrOptimized", after.acmr }, { "atvr", before.atvr }, { "atvrOptimized", after.atvr } });
+    }
+
+    void benchmarkVertexCache(BenchmarkUtil::Report& report)
+    {
+        std::printf("optimizeVertexCache, FIFO cache of 16 vertices\n");
+        std::printf("%16s %10s %8s %8s %8s %8s %12s\n", "mesh", "triangles", "ACMR", "ACMR opt", "ATVR", "ATVR opt", "median [ms]");
+
+        for (uint8_t subdivisions = 3u; subdivisions <= 7u; subdivisions += 2u)
+        {
+            size_t vertexCount;
+            size_t indexCount;
+            GeometryUtil::calculateVertexIndexCountsGeoSphere(subdivisions, vertexCount, indexCount);
+
+            std::unique_ptr<uint8_t[]> pVertices = std::make_unique<uint8_t[]>(vertexCount * GeometryUtil::defaultVertexDesc.stride);
+            std::unique_ptr<uint32_t[]> pIndices = std::make_unique<uint32_t[]>(indexCount);
+            GeometryUtil::createGeoSphere<GeometryUtil::defaultVertexDesc>(1.0f, subdivisions, pVertices.get(), pIndices.get());
+
+            char meshName[32];
+            std::snprintf(meshName, sizeof(meshName), "geosphere %u", subdivisions);
+            benchmarkVertexCacheOptimization(report, meshName, vertexCount, pIndices.get(), indexCount);
+        }
+
+        constexpr uint32_t vertexCountsPerSide[] = { 100u, 256u, 1024u };
+        for (const uint32_t vertexCountPerSide : vertexCountsPerSide)
+        {
+            size_t vertexCount;
+            size_t indexCount;
+            GeometryUtil::calculateVertexIndexCountsSquare(vertexCountPerSide, vertexCount, indexCount);
+
+            std::unique_ptr<uint8_t[]> pVertices = std::make_unique<uint8_t[]>(vertexCount * GeometryUtil::defaultVertexDesc.stride);
+            std::unique_ptr<uint32_t[]> pIndices = std::make_unique<uint32_t[]>(indexCount);
+            GeometryUtil::createSquare<GeometryUtil::defaultVertexDesc>(1.0f, vertexCountPerSide, pVertices.get(), pIndices.get());
+
+            char meshName[32];
+            std::snprintf(meshName, sizeof(meshName), "square %u", vertexCountPerSide);
+            benchmarkVertexCacheOptimization(report, meshName, vertexCount, pIndices.get(), indexCount);
+        }
+    }
+
+    // Meshlets that isMeshletBackFacing culls although one of their triangles faces the camera. Facing is judged by the
+    // generator's outward vertex normals rather than by the winding, so a wrong winding assumption in buildMeshlets
+    // shows up here. culledMeshletCount counts the meshlets culled over all camera positions.
+    size_t countWronglyCulledMeshlets(const std::vector<MeshletUtil::Meshlet>& meshlets, const std::vector<uint32_t>& meshletVertices, const std::vector<uint8_t>& meshletTriangles,
+        const void* const vertices, const DirectX::XMFLOAT3* const cameraPositions, const size_t cameraPositionCount, size_t& culledMeshletCount)
+    {
+        const size_t stride = GeometryUtil::defaultVertexDesc.stride;
+        const size_t normalByteOffset = GeometryUtil::findAttributeByteOffset(GeometryUtil::defaultVertexDesc, GeometryUtil::VertexAttributeType::NORMAL);
+        const auto loadAttribute = [&](const uint32_t vertex, const size_t byteOffset)
+        {
+            return DirectX::XMLoadFloat3(reinterpret_cast<const DirectX::XMFLOAT3*>(reinterpret_cast<const uint8_t*>(vertices) + vertex * stride + byteOffset));
+        };
+
+        size_t wronglyCulledMeshletCount = 0;
+        culledMeshletCount = 0;
+        for (size_t cameraIndex = 0; cameraIndex < cameraPositionCount; ++cameraIndex)
+        {
+            const DirectX::XMVECTOR xmvCameraPosition = DirectX::XMLoadFloat3(&cameraPositions[cameraIndex]);
+            for (const MeshletUtil::Meshlet& meshlet : meshlets)
+            {
+                if (!MeshletUtil::isMeshletBackFacing(meshlet, xmvCameraPosition))
+                {
+                    continue;
+                }
+                ++culledMeshletCount;
+
+                for (size_t triangle = 0; triangle < meshlet.triangleCount; ++triangle)
+                {
+                    uint32_t triangleVertices[3];
+                    for (size_t corner = 0; corner < 3u; ++corner)
+                    {
+                        triangleVertices[corner] = meshletVertices[meshlet.vertexOffset + meshletTriangles[meshlet.triangleOffset + triangle * 3u + corner]];
+                    }
+                    const DirectX::XMVECTOR xmvPosition0 = loadAttribute(triangleVertices[0], 0u);
+                    DirectX::XMVECTOR xmvNormal = DirectX::XMVector3Cross(DirectX::XMVectorSubtract(loadAttribute(triangleVertices[1], 0u), xmvPosition0),
+                        DirectX::XMVectorSubtract(loadAttribute(triangleVertices[2], 0u), xmvPosition0));
+                    const DirectX::XMVECTOR xmvVertexNormalSum = DirectX::XMVectorAdd(loadAttribute(triangleVertices[0], normalByteOffset),
+                        DirectX::XMVectorAdd(loadAttribute(triangleVertices[1], normalByteOffset), loadAttribute(triangleVertices[2], normalByteOffset)));
+                    if (DirectX::XMVectorGetX(DirectX::XMVector3Dot(xmvNormal, xmvVertexNormalSum)) < 0.0f)
+                    {
+                        xmvNormal = DirectX::XMVectorNegate(xmvNormal);
+                    }
+
+                    if (DirectX::XMVectorGetX(DirectX::XMVector3Dot(xmvNormal, DirectX::XMVectorSubtract(xmvCameraPosition, xmvPosition0))) > 0.0f)
+                    {
+                        ++wronglyCulledMeshletCount;
+                        break;
+                    }
+                }
+            }
+        }
+        return wronglyCulledMeshletCount;
+    }
+
+    template <typename IndexType>
+    size_t benchmarkMeshletsMesh(BenchmarkUtil::Report& report, const char* const meshName, const void* const vertices, const size_t vertexCount, const IndexType* const indices, const size_t indexCount,
+        const DirectX::XMFLOAT3* const cameraPositions, const size_t cameraPositionCount)
+    {
+        std::vector<MeshletUtil::Meshlet> meshlets;
+        std::vector<uint32_t> meshletVertices;
+        std::vector<uint8_t> meshletTriangles;
+        const BenchmarkUtil::Result result = BenchmarkUtil::measure([&]()
+        {
+            MeshletUtil::buildMeshlets(meshlets, meshletVertices, meshletTriangles, indices, indexCount, vertices, vertexCount, GeometryUtil::defaultVertexDesc);
+        });
+
+        const size_t meshletCount = meshlets.size();
+        const size_t cullableMeshletCount = static_cast<size_t>(std::count_if(meshlets.begin(), meshlets.end(),
+            [](const MeshletUtil::Meshlet& meshlet) { return meshlet.coneCutoff < 1.0f; }));
+        size_t culledMeshletCount;
+        const size_t wronglyCulledMeshletCount = countWronglyCulledMeshlets(meshlets, meshletVertices, meshletTriangles, vertices, cameraPositions, cameraPositionCount, culledMeshletCount);
+        std::printf("%16s %10zu %8zu %8.1f %8.1f %8.3f %8zu %8zu %8zu %12.4f\n", meshName, indexCount / 3u, meshletCount,
+            static_cast<double>(meshletVertices.size()) / static_cast<double>(meshletCount), static_cast<double>(indexCount / 3u) / static_cast<double>(meshletCount),
+            static_cast<double>(meshletVertices.size()) / static_cast<double>(vertexCount), cullableMeshletCount, culledMeshletCount, wronglyCulledMeshletCount, result.medianMilliseconds);
+        report.add(std::string("buildMeshlets/") + meshName, result, { { "meshlets", static_cast<double>(meshletCount) },
+            { "vertexRatio", static_cast<double>(meshletVertices.size()) / static_cast<double>(vertexCount) }, { "cullableMeshlets", static_cast<double>(cullableMeshletCount) },
+            { "culledMeshlets", static_cast<double>(culledMeshletCount) } });
+        return wronglyCulledMeshletCount;
+    }
+
+    // returns the number of meshlets that were culled although they face the camera, which has to be 0
+    size_t benchmarkMeshlets(BenchmarkUtil::Report& report)
+    {
+        std::printf("buildMeshlets, at most %zu vertices and %zu triangles\n", MeshletUtil::maxMeshletVertexCount, MeshletUtil::maxMeshletTriangleCount);
+        // The vertex ratio is the number of meshlet vertices per mesh vertex, cullable meshlets have a normal cone.
+        // Culled counts the meshlets culled from cameras outside the mesh, over all of them, wrong the culled ones with
+        // a triangle facing the camera.
+        std::printf("%16s %10s %8s %8s %8s %8s %8s %8s %8s %12s\n", "mesh", "triangles", "meshlets", "vertices", "tris", "ratio", "cullable", "culled", "wrong", "median [ms]");
+
+        // outside the unit geosphere, and above the square, which faces +y
+        constexpr DirectX::XMFLOAT3 geoSphereCameraPositions[] = {
+            { 3.0f, 0.0f, 0.0f }, { -3.0f, 0.0f, 0.0f }, { 0.0f, 3.0f, 0.0f }, { 0.0f, -3.0f, 0.0f }, { 0.0f, 0.0f, 3.0f }, { 0.0f, 0.0f, -3.0f }, { 1.5f, -1.2f, 1.1f }
+        };
+        constexpr DirectX::XMFLOAT3 squareCameraPositions[] = {
+            { 0.0f, 2.0f, 0.0f }, { 1.5f, 0.5f, -1.0f }, { -3.0f, 0.2f, 2.0f }
+        };
+
+        size_t wronglyCulledMeshletCount = 0;
+        for (uint8_t subdivisions = 3u; subdivisions <= 7u; subdivisions += 2u)
+        {
+            size_t vertexCount;
+            size_t indexCount;
+            GeometryUtil::calculateVertexIndexCountsGeoSphere(subdivisions, vertexCount, indexCount);
+
+            std::unique_ptr<uint8_t[]> pVertices = std::make_unique<uint8_t[]>(vertexCount * GeometryUtil::defaultVertexDesc.stride);
+            std::unique_ptr<uint32_t[]> pIndices = std::make_unique<uint32_t[]>(indexCount);
+            GeometryUtil::createGeoSphere<GeometryUtil::defaultVertexDesc>(1.0f, subdivisions, pVertices.get(), pIndices.get());
+
+            char meshName[32];
+            std::snprintf(meshName, sizeof(meshName), "geosphere %u", subdivisions);
+            wronglyCulledMeshletCount += benchmarkMeshletsMesh(report, meshName, pVertices.get(), vertexCount, pIndices.get(), indexCount,
+                geoSphereCameraPositions, sizeof(geoSphereCameraPositions) / sizeof(geoSphereCameraPositions[0]));
+        }
+
+        constexpr uint32_t vertexCountsPerSide[] = { 64u, 256u, 1024u };
+        for (const uint32_t vertexCountPerSide : vertexCountsPerSide)
+        {
+            size_t vertexCount;
+            size_t indexCount;
+            GeometryUtil::calculateVertexIndexCountsSquare(vertexCountPerSide, vertexCount, indexCount);
+
+            std::unique_ptr<uint8_t[]> pVertices = std::make_unique<uint8_t[]>(vertexCount * GeometryUtil::defaultVertexDesc.stride);
+            std::unique_ptr<uint32_t[]> pIndices = std::make_unique<uint32_t[]>(indexCount);
+            GeometryUtil::createSquare<GeometryUtil::defaultVertexDesc>(1.0f, vertexCountPerSide, pVertices.get(), pIndices.get());
+
+            char meshName[32];
+            std::snprintf(meshName, sizeof(meshName), "square %u", vertexCountPerSide);
+            wronglyCulledMeshletCount += benchmarkMeshletsMesh(report, meshName, pVertices.get(), vertexCount, pIndices.get(), indexCount,
+                squareCameraPositions, sizeof(squareCameraPositions) / sizeof(squareCameraPositions[0]));
+        }
+        return wronglyCulledMeshletCount;
+    }
+
+    template <typename IndexType>
+    void benchmarkSimplificationTarget(BenchmarkUtil::Report& report, const char* const meshName, const void* const vertices, const size_t vertexCount, const IndexType* const indices, const size_t indexCount,
+        const size_t targetIndexCount, const float targetError)
+    {
+        std::unique_ptr<IndexType[]> pSimplifiedIndices = std::make_unique<IndexType[]>(indexCount);
+        size_t simplifiedIndexCount = 0;
+        float resultError = 0.0f;
+        const BenchmarkUtil::Result result = BenchmarkUtil::measure([&]()
+        {
+            simplifiedIndexCount = MeshSimplificationUtil::simplifyMesh(pSimplifiedIndices.get(), indices, indexCount, vertices, vertexCount, GeometryUtil::defaultVertexDesc,
+                targetIndexCount, targetError, true, &resultError);
+        });
+
+        char maxError[16] = "none";
+        if (targetError < FLT_MAX)
+        {
+            std::snprintf(maxError, sizeof(maxError), "%.5f", targetError);
+        }
+        std::printf("%16s %10zu %10zu %10zu %10s %10.5f %12.4f\n", meshName, indexCount / 3u, targetIndexCount / 3u, simplifiedIndexCount / 3u,
+            maxError, resultError, result.medianMilliseconds);
+        report.add(std::string("simplifyMesh/") + meshName + "/target:" + std::to_string(targetIndexCount / 3u) + "/maxError:" + maxError, result,
+            { { "triangles", static_cast<double>(simplifiedIndexCount / 3u) }, { "error", resultError } });
+    }
+
+    void benchmarkSimplification(BenchmarkUtil::Report& report)
+    {
+        std::printf("simplifyMesh with locked borders, errors relative to the mesh extent\n");
+        std::printf("%16s %10s %10s %10s %10s %10s %12s\n", "mesh", "triangles", "target", "result", "max error", "error", "median [ms]");
+
+        {
+            constexpr uint8_t subdivisions = 7u;
+            size_t vertexCount;
+            size_t indexCount;
+            GeometryUtil::calculateVertexIndexCountsGeoSphere(subdivisions, vertexCount, indexCount);
+
+            std::unique_ptr<uint8_t[]> pVertices = std::make_unique<uint8_t[]>(vertexCount * GeometryUtil::defaultVertexDesc.stride);
+            std::unique_ptr<uint32_t[]> pIndices = std::make_unique<uint32_t[]>(indexCount);
+            GeometryUtil::createGeoSphere<GeometryUtil::defaultVertexDesc>(1.0f, subdivisions, pVertices.get(), pIndices.get());
+
+            benchmarkSimplificationTarget(report, "geosphere 7", pVertices.get(), vertexCount, pIndices.get(), indexCount, indexCount / 12u * 3u, FLT_MAX);
+            benchmarkSimplificationTarget(report, "geosphere 7", pVertices.get(), vertexCount, pIndices.get(), indexCount, indexCount / 300u * 3u, FLT_MAX);
+        }
+
+        constexpr uint32_t vertexCountsPerSide[] = { 256u, 512u };
+        for (const uint32_t vertexCountPerSide : vertexCountsPerSide)
+        {
+            size_t vertexCount;
+            size_t indexCount;
+            GeometryUtil::calculateVertexIndexCountsSquare(vertexCountPerSide, vertexCount, indexCount);
+
+            std::unique_ptr<uint8_t[]> pVertices = std::make_unique<uint8_t[]>(vertexCount * GeometryUtil::defaultVertexDesc.stride);
+            std::unique_ptr<uint32_t[]> pIndices = std::make_unique<uint32_t[]>(indexCount);
+            GeometryUtil::createSquare<GeometryUtil::defaultVertexDesc>(1.0f, vertexCountPerSide, pVertices.get(), pIndices.get());
+
+            // rolling hills like the land in LandAndWavesBlended
+            for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+            {
+                DirectX::XMFLOAT3* const pPosition = reinterpret_cast<DirectX::XMFLOAT3*>(pVertices.get() + vertex * GeometryUtil::defaultVertexDesc.stride);
+                pPosition->y = 0.25f * (pPosition->z * std::sin(16.0f * pPosition->x) + pPosition->x * std::cos(16.0f * pPosition->z));
+            }
+
+            char meshName[32];
+            std::snprintf(meshName, sizeof(meshName), "terrain %u", vertexCountPerSide);
+            benchmarkSimplificationTarget(report, meshName, pVertices.get(), vertexCount, pIndices.get(), indexCount, 0u, 0.001f);
+            benchmarkSimplificationTarget(report, meshName, pVertices.get(), vertexCount, pIndices.get(), indexCount, indexCount / 30u * 3u, FLT_MAX);
+        }
+    }
+
+    void benchmarkVertexConversionLayout(BenchmarkUtil::Report& report, const char* const meshName, const char* const layoutName, const GeometryUtil::VertexDesc& dstDesc, const void* const vertices, const size_t vertexCount)
+    {
+        std::unique_ptr<uint8_t[]> pConvertedVertices = std::make_unique<uint8_t[]>(vertexCount * dstDesc.stride);
+        const BenchmarkUtil::Result result = BenchmarkUtil::measure([&]()
+        {
+            GeometryUtil::convertVertices(pConvertedVertices.get(), dstDesc, vertices, GeometryUtil::defaultVertexDesc, vertexCount);
+        });
+
+        // bytes read and written per second
+        const double byteCount = static_cast<double>(vertexCount * (GeometryUtil::defaultVertexDesc.stride + dstDesc.stride));
+        const double gigabytesPerSecond = byteCount / (result.medianMilliseconds * 1.0e6);
+        std::printf("%16s %10zu %10s %6zu %12.4f %10.2f\n", meshName, vertexCount, layoutName, dstDesc.stride, result.medianMilliseconds, gigabytesPerSecond);
+        report.add(std::string("convertVertices/") + meshName + "/layout:" + layoutName, result, { { "gigabytesPerSecond", gigabytesPerSecond } });
+    }
+
+    void benchmarkVertexConversion(BenchmarkUtil::Report& report)
+    {
+        std::printf("convertVertices from %zu byte float vertices\n", GeometryUtil::defaultVertexDesc.stride);
+        std::printf("%16s %10s %10s %6s %12s %10s\n", "mesh", "vertices", "layout", "bytes", "median [ms]", "GB/s");
+
+        {
+            constexpr uint8_t subdivisions = 7u;
+            size_t vertexCount;
+            size_t indexCount;
+            GeometryUtil::calculateVertexIndexCountsGeoSphere(subdivisions, vertexCount, indexCount);
+
+            std::unique_ptr<uint8_t[]> pVertices = std::make_unique<uint8_t[]>(vertexCount * GeometryUtil::defaultVertexDesc.stride);
+            std::unique_ptr<uint32_t[]> pIndices = std::make_unique<uint32_t[]>(indexCount);
+            GeometryUtil::createGeoSphere<GeometryUtil::defaultVertexDesc>(1.0f, subdivisions, pVertices.get(), pIndices.get());
+
+            benchmarkVertexConversionLayout(report, "geosphere 7", "compact", GeometryUtil::compactVertexDesc, pVertices.get(), vertexCount);
+            benchmarkVertexConversionLayout(report, "geosphere 7", "quantized", quantizedVertexDesc, pVertices.get(), vertexCount);
+        }
+
+        {
+            constexpr uint32_t vertexCountPerSide = 1024u;
+            size_t vertexCount;
+            size_t indexCount;
+            GeometryUtil::calculateVertexIndexCountsSquare(vertexCountPerSide, vertexCount, indexCount);
+
+            std::unique_ptr<uint8_t[]> pVertices = std::make_unique<uint8_t[]>(vertexCount * GeometryUtil::defaultVertexDesc.stride);
+            std::unique_ptr<uint32_t[]> pIndices = std::make_unique<uint32_t[]>(indexCount);
+            GeometryUtil::createSquare<GeometryUtil::defaultVertexDesc>(1.0f, vertexCountPerSide, pVertices.get(), pIndices.get());
+
+            benchmarkVertexConversionLayout(report, "square 1024", "compact", GeometryUtil::compactVertexDesc, pVertices.get(), vertexCount);
+            benchmarkVertexConversionLayout(report, "square 1024", "quantized", quantizedVertexDesc, pVertices.get(), vertexCount);
+        }
+    }
+
+    // the straightforward two pass loop calculateBounds replaces, for float positions at the start of every vertex
+    GeometryUtil::Bounds calculateBoundsScalar(const void* const vertices, const size_t stride, const size_t vertexCount)
+    {
+        const uint8_t* const vertexBytes = static_cast<const uint8_t*>(vertices);
+        GeometryUtil::Bounds bounds = {};
+        bounds.aabbMin = { FLT_MAX, FLT_MAX, FLT_MAX };
+        bounds.aabbMax = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+        for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+        {
+            DirectX::XMFLOAT3 position;
+            std::memcpy(&position, vertexBytes + vertex * stride, sizeof(position));
+            bounds.aabbMin = { std::min(bounds.aabbMin.x, position.x), std::min(bounds.aabbMin.y, position.y), std::min(bounds.aabbMin.z, position.z) };
+            bounds.aabbMax = { std::max(bounds.aabbMax.x, position.x), std::max(bounds.aabbMax.y, position.y), std::max(bounds.aabbMax.z, position.z) };
+        }
+
+        bounds.sphereCenter = { 0.5f * (bounds.aabbMin.x + bounds.aabbMax.x), 0.5f * (bounds.aabbMin.y + bounds.aabbMax.y), 0.5f * (bounds.aabbMin.z + bounds.aabbMax.z) };
+        float maxDistanceSq = 0.0f;
+        for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+        {
+            DirectX::XMFLOAT3 position;
+            std::memcpy(&position, vertexBytes + vertex * stride, sizeof(position));
+            const float x = position.x - bounds.sphereCenter.x;
+            const float y = position.y - bounds.sphereCenter.y;
+            const float z = position.z - bounds.sphereCenter.z;
+            maxDistanceSq = std::max(maxDistanceSq, x * x + y * y + z * z);
+        }
+        bounds.sphereRadius = std::sqrt(maxDistanceSq);
+        return bounds;
+    }
+
+    void benchmarkBoundsLayout(BenchmarkUtil::Report& report, const char* const meshName, const char* const layoutName, const GeometryUtil::VertexDesc& vertexDesc, const void* const vertices, const size_t vertexCount)
+    {
+        GeometryUtil::Bounds bounds = {};
+        const BenchmarkUtil::Result singleThreadResult = BenchmarkUtil::measure([&]()
+        {
+            bounds = GeometryUtil::calculateBounds(vertices, vertexDesc, vertexCount, 1u);
+        });
+        const BenchmarkUtil::Result result = BenchmarkUtil::measure([&]()
+        {
+            bounds = GeometryUtil::calculateBounds(vertices, vertexDesc, vertexCount);
+        });
+
+        const std::string name = std::string("calculateBounds/") + meshName + "/layout:" + layoutName;
+        report.add(name + "/threads:1", singleThreadResult);
+        report.add(name + "/threads:auto", result);
+
+        // the scalar loop only reads float positions
+        if (vertexDesc.pAttributeDescs[0].attributeType == GeometryUtil::VertexAttributeType::POSITION && vertexDesc.pAttributeDescs[0].attributeByteOffset == 0u)
+        {
+            const BenchmarkUtil::Result scalarResult = BenchmarkUtil::measure([&]()
+            {
+                bounds = calculateBoundsScalar(vertices, vertexDesc.stride, vertexCount);
+            });
+            report.add(name + "/scalar", scalarResult);
+            std::printf("%16s %10zu %10s %12.4f %12.4f %12.4f %8.2fx\n", meshName, vertexCount, layoutName, scalarResult.medianMilliseconds,
+                singleThreadResult.medianMilliseconds, result.medianMilliseconds, scalarResult.medianMilliseconds / singleThreadResult.medianMilliseconds);
+        }
+        else
+        {
+            std::printf("%16s %10zu %10s %12s %12.4f %12.4f %9s\n", meshName, vertexCount, layoutName, "-", singleThreadResult.medianMilliseconds, result.medianMilliseconds, "-");
+        }
+    }
+
+    void benchmarkBounds(BenchmarkUtil::Report& report)
+    {
+        std::printf("calculateBounds vs. a scalar two pass loop, speedup of 1 SIMD thread over the scalar loop\n");
+        std::printf("%16s %10s %10s %12s %12s %12s %9s\n", "mesh", "vertices", "layout", "scalar [ms]", "simd 1 [ms]", "simd [ms]", "speedup");
+
+        const auto benchmarkLayouts = [&report](const char* const meshName, const void* const vertices, const size_t vertexCount)
+        {
+            std::unique_ptr<uint8_t[]> pCompactVertices = std::make_unique<uint8_t[]>(vertexCount * GeometryUtil::compactVertexDesc.stride);
+            GeometryUtil::convertVertices(pCompactVertices.get(), GeometryUtil::compactVertexDesc, vertices, GeometryUtil::defaultVertexDesc, vertexCount);
+            std::unique_ptr<uint8_t[]> pQuantizedVertices = std::make_unique<uint8_t[]>(vertexCount * quantizedVertexDesc.stride);
+            GeometryUtil::convertVertices(pQuantizedVertices.get(), quantizedVertexDesc, vertices, GeometryUtil::defaultVertexDesc, vertexCount);
+
+            benchmarkBoundsLayout(report, meshName, "default", GeometryUtil::defaultVertexDesc, vertices, vertexCount);
+            benchmarkBoundsLayout(report, meshName, "compact", GeometryUtil::compactVertexDesc, pCompactVertices.get(), vertexCount);
+            benchmarkBoundsLayout(report, meshName, "quantized", quantizedVertexDesc, pQuantizedVertices.get(), vertexCount);
+        };
+
+        // the per frame case, the size of the waves in LandAndWavesBlended
+        constexpr uint32_t vertexCountsPerSide[] = { 100u, 1024u };
+        for (const uint32_t vertexCountPerSide : vertexCountsPerSide)
+        {
+            size_t vertexCount;
+            size_t indexCount;
+            GeometryUtil::calculateVertexIndexCountsSquare(vertexCountPerSide, vertexCount, indexCount);
+
+            std::unique_ptr<uint8_t[]> pVertices = std::make_unique<uint8_t[]>(vertexCount * GeometryUtil::defaultVertexDesc.stride);
+            std::unique_ptr<uint32_t[]> pIndices = std::make_unique<uint32_t[]>(indexCount);
+            GeometryUtil::createSquare<GeometryUtil::defaultVertexDesc>(1.0f, vertexCountPerSide, pVertices.get(), pIndices.get());
+            for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+            {
+                DirectX::XMFLOAT3* const pPosition = reinterpret_cast<DirectX::XMFLOAT3*>(pVertices.get() + vertex * GeometryUtil::defaultVertexDesc.stride);
+                pPosition->y = 0.1f * std::sin(40.0f * pPosition->x + 30.0f * pPosition->z);
+            }
+
+            char meshName[32];
+            std::snprintf(meshName, sizeof(meshName), "waves %u", vertexCountPerSide);
+            benchmarkLayouts(meshName, pVertices.get(), vertexCount);
+        }
+    }
+
+    template <typename Generate, typename GenerateWriteCombined>
+    void benchmarkUploadGenerationMesh(BenchmarkUtil::Report& report, const char* const meshName, const char* const layoutName, const size_t vertexCount, const size_t vertexSize, const size_t indexCount,
+        Generate&& generate, GenerateWriteCombined&& generateWriteCombined)
+    {
+        // stands in for the mapped upload heap, allocated once like the upload buffers of a mesh
+        const size_t vertexByteCount = vertexCount * vertexSize;
+        const size_t indexByteCount = indexCount * sizeof(uint32_t);
+        std::vector<uint8_t> uploadBuffer(vertexByteCount + indexByteCount);
+
+        const BenchmarkUtil::Result copyResult = BenchmarkUtil::measure([&]()
+        {
+            std::unique_ptr<uint8_t[]> pVertices = std::make_unique<uint8_t[]>(vertexByteCount);
+            std::unique_ptr<uint32_t[]> pIndices = std::make_unique<uint32_t[]>(indexCount);
+            generate(pVertices.get(), pIndices.get());
+            std::memcpy(uploadBuffer.data(), pVertices.get(), vertexByteCount);
+            std::memcpy(uploadBuffer.data() + vertexByteCount, pIndices.get(), indexByteCount);
+        });
+
+        const BenchmarkUtil::Result directResult = BenchmarkUtil::measure([&]()
+        {
+            generateWriteCombined(uploadBuffer.data(), reinterpret_cast<uint32_t*>(uploadBuffer.data() + vertexByteCount));
+        });
+
+        std::printf("%16s %10s %10zu %14.4f %14.4f %8.2fx\n", meshName, layoutName, vertexCount, copyResult.medianMilliseconds, directResult.medianMilliseconds,
+            copyResult.medianMilliseconds / directResult.medianMilliseconds);
+        const std::string name = std::string("uploadGeneration/") + meshName + "/layout:" + layoutName;
+        report.add(name + "/copy", copyResult);
+        report.add(name + "/direct", directResult);
+    }
+
+    void benchmarkUploadGeneration(BenchmarkUtil::Report& report)
+    {
+        // the destination is cached memory here, in a real upload heap the direct path also avoids reading it
+        std::printf("generating into temporary arrays and copying them vs. WriteCombinedVertexWriter straight into the destination\n");
+        std::printf("%16s %10s %10s %14s %14s %9s\n", "mesh", "layout", "vertices", "copy [ms]", "direct [ms]", "speedup");
+
+        {
+            constexpr uint8_t subdivisions = 7u;
+            size_t vertexCount;
+            size_t indexCount;
+            GeometryUtil::calculateVertexIndexCountsGeoSphere(subdivisions, vertexCount, indexCount);
+            benchmarkUploadGenerationMesh(report, "geosphere 7", "default", vertexCount, GeometryUtil::defaultVertexDesc.stride, indexCount,
+                [](void* const vertices, uint32_t* const indices)
+                {
+                    GeometryUtil::createGeoSphere<GeometryUtil::defaultVertexDesc>(1.0f, subdivisions, vertices, indices);
+                },
+                [](void* const vertices, uint32_t* const indices)
+                {
+                    GeometryUtil::createGeoSphere(1.0f, subdivisions, vertices, indices, GeometryUtil::StaticWriteCombinedVertexWriter<GeometryUtil::defaultVertexDesc>());
+                });
+        }
+
+        constexpr uint32_t vertexCountPerSide = 1024u;
+        size_t vertexCount;
+        size_t indexCount;
+        GeometryUtil::calculateVertexIndexCountsSquare(vertexCountPerSide, vertexCount, indexCount);
+        benchmarkUploadGenerationMesh(report, "square 1024", "default", vertexCount, GeometryUtil::defaultVertexDesc.stride, indexCount,
+            [](void* const vertices, uint32_t* const indices)
+            {
+                GeometryUtil::createSquare<GeometryUtil::defaultVertexDesc>(1.0f, vertexCountPerSide, vertices, indices);
+            },
+            [](void* const vertices, uint32_t* const indices)
+            {
+                GeometryUtil::createSquare(1.0f, vertexCountPerSide, vertices, indices, GeometryUtil::StaticWriteCombinedVertexWriter<GeometryUtil::defaultVertexDesc>());
+            });
+        // 20 byte vertices cannot use aligned non-temporal stores and fall back to plain stores of whole vertices
+        benchmarkUploadGenerationMesh(report, "square 1024", "compact", vertexCount, GeometryUtil::compactVertexDesc.stride, indexCount,
+            [](void* const vertices, uint32_t* const indices)
+            {
+                GeometryUtil::createSquare<GeometryUtil::compactVertexDesc>(1.0f, vertexCountPerSide, vertices, indices);
+            },
+            [](void* const vertices, uint32_t* const indices)
+            {
+                GeometryUtil::createSquare(1.0f, vertexCountPerSide, vertices, indices, GeometryUtil::StaticWriteCombinedVertexWriter<GeometryUtil::compactVertexDesc>());
+            });
+    }
+
+    // generated meshes own their data, generate fills them and returns a view of it
+    struct GeneratedMesh
+    {
+        std::unique_ptr<uint8_t[]> pVertices;
+        std::unique_ptr<uint32_t[]> pIndices;
+    };
+
+    template <typename Generate>
+    void benchmarkGeometryCacheMesh(BenchmarkUtil::Report& report, const char* const meshName, const std::filesystem::path& directory, const uint64_t key, Generate&& generate)
+    {
+        // stands in for the upload heap every path ends up copying into
+        std::vector<uint8_t> uploadBuffer;
+        const auto upload = [&uploadBuffer](const GeometryCacheUtil::MeshView& mesh)
+        {
+            const size_t vertexByteCount = mesh.vertexCount * mesh.vertexSize;
+            const size_t indexByteCount = mesh.indexCount * mesh.indexSize;
+            uploadBuffer.resize(vertexByteCount + indexByteCount);
+            std::memcpy(uploadBuffer.data(), mesh.pVertices, vertexByteCount);
+            std::memcpy(uploadBuffer.data() + vertexByteCount, mesh.pIndices, indexByteCount);
+        };
+
+        const BenchmarkUtil::Result generateResult = BenchmarkUtil::measure([&]()
+        {
+            GeneratedMesh generated;
+            upload(generate(generated));
+        });
+
+        // a cold start misses the cache, generates the mesh and stores it for the next launch
+        const BenchmarkUtil::Result coldResult = BenchmarkUtil::measure([&]()
+        {
+            GeometryCacheUtil::MappedMesh mappedMesh;
+            if (!mappedMesh.map(directory / "cold", key))
+            {
+                GeneratedMesh generated;
+                const GeometryCacheUtil::MeshView mesh = generate(generated);
+                GeometryCacheUtil::storeMesh(directory / "cold", key, mesh);
+                upload(mesh);
+            }
+            std::filesystem::remove_all(directory / "cold");
+        });
+
+        GeneratedMesh generated;
+        const GeometryCacheUtil::MeshView mesh = generate(generated);
+        GeometryCacheUtil::storeMesh(directory, key, mesh);
+        const size_t byteCount = mesh.vertexCount * mesh.vertexSize + mesh.indexCount * mesh.indexSize;
+        const BenchmarkUtil::Result warmResult = BenchmarkUtil::measure([&]()
+        {
+            GeometryCacheUtil::MappedMesh mappedMesh;
+            mappedMesh.map(directory, key);
+            upload(mappedMesh.getView());
+        });
+
+        std::printf("%16s %10.1f %12.4f %12.4f %12.4f %8.1fx\n", meshName, static_cast<double>(byteCount) / 1024.0, generateResult.medianMilliseconds,
+            coldResult.medianMilliseconds, warmResult.medianMilliseconds, generateResult.medianMilliseconds / warmResult.medianMilliseconds);
+        const std::string name = std::string("geometryCache/") + meshName;
+        report.add(name + "/generate", generateResult);
+        report.add(name + "/cold", coldResult);
+        report.add(name + "/warm", warmResult, { { "kilobytes", static_cast<double>(byteCount) / 1024.0 } });
+    }
+
+    void benchmarkGeometryCache(BenchmarkUtil::Report& report)
+    {
+        const std::filesystem::path directory = std::filesystem::temp_directory_path() / "geometry-bench-cache";
+        std::filesystem::remove_all(directory);
+
+        // each path includes copying the mesh into an upload buffer, warm starts map files in the page cache
+        std::printf("GeometryCacheUtil, regenerating vs. a cold start that stores the mesh vs. a warm start that maps it\n");
+        std::printf("%16s %10s %12s %12s %12s %9s\n", "mesh", "data [KiB]", "generate", "cold [ms]", "warm [ms]", "speedup");
+
+        for (uint8_t subdivisions = 3u; subdivisions <= 7u; subdivisions += 4u)
+        {
+            char meshName[32];
+            std::snprintf(meshName, sizeof(meshName), "geosphere %u", subdivisions);
+            uint64_t key = GeometryCacheUtil::hashString("geosphere");
+            key = GeometryCacheUtil::hashValue(subdivisions, key);
+            key = GeometryCacheUtil::hashVertexDesc(GeometryUtil::defaultVertexDesc, key);
+            benchmarkGeometryCacheMesh(report, meshName, directory, key, [subdivisions](GeneratedMesh& generated)
+            {
+                size_t vertexCount;
+                size_t indexCount;
+                GeometryUtil::calculateVertexIndexCountsGeoSphere(subdivisions, vertexCount, indexCount);
+
+                generated.pVertices = std::make_unique<uint8_t[]>(vertexCount * GeometryUtil::defaultVertexDesc.stride);
+                generated.pIndices = std::make_unique<uint32_t[]>(indexCount);
+                GeometryUtil::createGeoSphere<GeometryUtil::defaultVertexDesc>(1.0f, subdivisions, generated.pVertices.get(), generated.pIndices.get());
+                return GeometryCacheUtil::MeshView{ generated.pVertices.get(), vertexCount, GeometryUtil::defaultVertexDesc.stride, generated.pIndices.get(), indexCount, sizeof(uint32_t) };
+            });
+        }
+
+        constexpr uint32_t vertexCountsPerSide[] = { 100u, 512u };
+        for (const uint32_t vertexCountPerSide : vertexCountsPerSide)
+        {
+            char meshName[32];
+            std::snprintf(meshName, sizeof(meshName), "terrain %u", vertexCountPerSide);
+            uint64_t key = GeometryCacheUtil::hashString("terrain");
+            key = GeometryCacheUtil::hashValue(vertexCountPerSide, key);
+            key = GeometryCacheUtil::hashVertexDesc(GeometryUtil::defaultVertexDesc, key);
+
+            // the same pipeline as the land in LandAndWavesBlended
+            benchmarkGeometryCacheMesh(report, meshName, directory, key, [vertexCountPerSide](GeneratedMesh& generated)
+            {
+                size_t vertexCount;
+                size_t indexCount;
+                GeometryUtil::calculateVertexIndexCountsSquare(vertexCountPerSide, vertexCount, indexCount);
+
+                std::unique_ptr<uint8_t[]> pVertices = std::make_unique<uint8_t[]>(vertexCount * GeometryUtil::defaultVertexDesc.stride);
+                std::unique_ptr<uint32_t[]> pIndices = std::make_unique<uint32_t[]>(indexCount);
+                GeometryUtil::createSquare<GeometryUtil::defaultVertexDesc>(1.0f, vertexCountPerSide, pVertices.get(), pIndices.get());
+                for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+                {
+                    DirectX::XMFLOAT3* const pPosition = reinterpret_cast<DirectX::XMFLOAT3*>(pVertices.get() + vertex * GeometryUtil::defaultVertexDesc.stride);
+                    pPosition->y = 0.25f * (pPosition->z * std::sin(16.0f * pPosition->x) + pPosition->x * std::cos(16.0f * pPosition->z));
+                }
+
+                indexCount = MeshSimplificationUtil::simplifyMesh(pIndices.get(), pIndices.get(), indexCount, pVertices.get(), vertexCount,
+                    GeometryUtil::defaultVertexDesc, 0u, 0.001f, true);
+                generated.pIndices = std::make_unique<uint32_t[]>(indexCount);
+                MeshOptimizationUtil::optimizeVertexCache(generated.pIndices.get(), pIndices.get(), indexCount, vertexCount);
+                generated.pVertices = std::make_unique<uint8_t[]>(vertexCount * GeometryUtil::defaultVertexDesc.stride);
+                vertexCount = MeshOptimizationUtil::optimizeVertexFetch(generated.pVertices.get(), generated.pIndices.get(), indexCount, pVertices.get(), vertexCount,
+                    GeometryUtil::defaultVertexDesc.stride);
+                return GeometryCacheUtil::MeshView{ generated.pVertices.get(), vertexCount, GeometryUtil::defaultVertexDesc.stride, generated.pIndices.get(), indexCount, sizeof(uint32_t) };
+            });
+        }
+
+        std::filesystem::remove_all(directory);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    // --json <path> additionally writes every measurement to a JSON file for comparing runs
+    const char* jsonPath = nullptr;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+        {
+            jsonPath = argv[++i];
+        }
+        else
+        {
+            std::fprintf(stderr, "usage: %s [--json <path>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    BenchmarkUtil::Report report;
+    report.addContext("hardwareThreads", static_cast<double>(ThreadUtil::getDefaultThreadCount()));
+
+    benchmarkGeoSphere(report);
+    const size_t mismatchedSquareVertexCount = benchmarkSquare(report);
+    benchmarkCounts(report);
+    benchmarkThreadScaling(report);
+    benchmarkVertexCache(report);
+    benchmarkVertexConversion(report);
+    benchmarkUploadGeneration(report);
+    benchmarkBounds(report);
+    const size_t wronglyCulledMeshletCount = benchmarkMeshlets(report);
+    benchmarkSimplification(report);
+    benchmarkGeometryCache(report);
+
+    if (jsonPath != nullptr && !report.writeJson(jsonPath))
+    {
+        std::fprintf(stderr, "could not write %s\n", jsonPath);
+        return 1;
+    }
+    if (mismatchedSquareVertexCount > 0u)
+    {
+        std::fprintf(stderr, "createSquare's 4 wide path wrote %zu vertices differently from the scalar path\n", mismatchedSquareVertexCount);
+        return 1;
+    }
+    if (wronglyCulledMeshletCount > 0u)
+    {
+        std::fprintf(stderr, "%zu meshlets were culled although they face the camera\n", wronglyCulledMeshletCount);
+        return 1;
+    }
+    return 0;
+}
\ No newline at end of file
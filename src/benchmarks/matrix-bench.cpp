@@ -0,0 +1,525 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <DirectXMath.h>
+
+#include "BenchmarkUtil.h"
+#include "ThreadUtil.h"
+#include "TransformUtil.h"
+#include "matrix.h"
+
+namespace
+{
+    // every heap allocation of the program, to check that the cofactor expansion does not allocate
+    std::atomic<size_t> allocationCount(0u);
+}
+
+void* operator new(const size_t size)
+{
+    ++allocationCount;
+    void* const pMemory = std::malloc(size > 0u ? size : 1u);
+    if (pMemory == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return pMemory;
+}
+
+void operator delete(void* const pMemory) noexcept
+{
+    std::free(pMemory);
+}
+
+void operator delete(void* const pMemory, const size_t) noexcept
+{
+    std::free(pMemory);
+}
+
+namespace
+{
+    // enough matrices per iteration to time them reliably, small enough to stay in the caches
+    constexpr size_t batchMatrixCount = 4096u;
+
+    struct Batch
+    {
+        std::vector<Matrix4<float>> lhs;
+        std::vector<Matrix4<float>> rhs;
+        std::vector<Matrix4<float>> result;
+        std::vector<DirectX::XMFLOAT4X4> xmLhs;
+        std::vector<DirectX::XMFLOAT4X4> xmRhs;
+        std::vector<DirectX::XMFLOAT4X4> xmResult;
+    };
+
+    Batch createBatch()
+    {
+        // well conditioned random matrices, the diagonal dominates so every matrix is invertible
+        std::mt19937 generator(42u);
+        std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+        const auto randomMatrix = [&]()
+        {
+            Matrix4<float> matrix;
+            for (size_t row = 0; row < 4u; ++row)
+            {
+                for (size_t col = 0; col < 4u; ++col)
+                {
+                    matrix[row][col] = distribution(generator) + (row == col ? 4.0f : 0.0f);
+                }
+            }
+            return matrix;
+        };
+
+        Batch batch;
+        batch.lhs.resize(batchMatrixCount);
+        batch.rhs.resize(batchMatrixCount);
+        batch.result.resize(batchMatrixCount);
+        batch.xmLhs.resize(batchMatrixCount);
+        batch.xmRhs.resize(batchMatrixCount);
+        batch.xmResult.resize(batchMatrixCount);
+        for (size_t i = 0; i < batchMatrixCount; ++i)
+        {
+            batch.lhs[i] = randomMatrix();
+            batch.rhs[i] = randomMatrix();
+            std::memcpy(&batch.xmLhs[i], &batch.lhs[i], sizeof(DirectX::XMFLOAT4X4));
+            std::memcpy(&batch.xmRhs[i], &batch.rhs[i], sizeof(DirectX::XMFLOAT4X4));
+        }
+        return batch;
+    }
+
+    // largest absolute difference to the DirectXMath results, the variants should only differ by rounding
+    float calculateMaxDifference(const Batch& batch)
+    {
+        float maxDifference = 0.0f;
+        for (size_t i = 0; i < batchMatrixCount; ++i)
+        {
+            for (size_t row = 0; row < 4u; ++row)
+            {
+                for (size_t col = 0; col < 4u; ++col)
+                {
+                    maxDifference = std::max(maxDifference, std::abs(batch.result[i][row][col] - batch.xmResult[i].m[row][col]));
+                }
+            }
+        }
+        return maxDifference;
+    }
+
+    // prints and reports the time per matrix, speedups are relative to the generic template
+    template <typename Func>
+    double benchmarkVariant(BenchmarkUtil::Report& report, const char* const operationName, const char* const variantName, const double genericNanoseconds, Func&& func)
+    {
+        const BenchmarkUtil::Result result = BenchmarkUtil::measure(func);
+        const double nanoseconds = result.medianMilliseconds * 1.0e6 / static_cast<double>(batchMatrixCount);
+        std::printf("%10s %12s %14.2f %8.2fx\n", operationName, variantName, nanoseconds, genericNanoseconds > 0.0 ? genericNanoseconds / nanoseconds : 1.0);
+        report.add(std::string(operationName) + "/variant:" + variantName, result, { { "nanosecondsPerMatrix", nanoseconds } });
+        return nanoseconds;
+    }
+
+    void benchmarkMatrix4(BenchmarkUtil::Report& report)
+    {
+        std::printf("Matrix4<float> operations, %zu matrices per iteration\n", batchMatrixCount);
+        std::printf("%10s %12s %14s %9s\n", "operation", "variant", "ns/matrix", "speedup");
+
+        Batch batch = createBatch();
+
+        // explicit template arguments select the generic templates over the SSE2 overloads
+        const double multiplyNanoseconds = benchmarkVariant(report, "multiply", "generic", 0.0, [&]()
+        {
+            for (size_t i = 0; i < batchMatrixCount; ++i)
+            {
+                batch.result[i] = operator*<float, 4>(batch.lhs[i], batch.rhs[i]);
+            }
+        });
+#if defined(MATRIX_SSE2)
+        benchmarkVariant(report, "multiply", "sse2", multiplyNanoseconds, [&]()
+        {
+            for (size_t i = 0; i < batchMatrixCount; ++i)
+            {
+                batch.result[i] = batch.lhs[i] * batch.rhs[i];
+            }
+        });
+#endif
+        benchmarkVariant(report, "multiply", "directxmath", multiplyNanoseconds, [&]()
+        {
+            for (size_t i = 0; i < batchMatrixCount; ++i)
+            {
+                const DirectX::XMMATRIX xmLhs = DirectX::XMLoadFloat4x4(&batch.xmLhs[i]);
+                const DirectX::XMMATRIX xmRhs = DirectX::XMLoadFloat4x4(&batch.xmRhs[i]);
+                DirectX::XMStoreFloat4x4(&batch.xmResult[i], DirectX::XMMatrixMultiply(xmLhs, xmRhs));
+            }
+        });
+        std::printf("%10s %12s %14g\n", "multiply", "max diff", calculateMaxDifference(batch));
+
+        const double transposeNanoseconds = benchmarkVariant(report, "transpose", "generic", 0.0, [&]()
+        {
+            for (size_t i = 0; i < batchMatrixCount; ++i)
+            {
+                batch.result[i] = batch.lhs[i];
+                transpose<float, 4>(batch.result[i]);
+            }
+        });
+#if defined(MATRIX_SSE2)
+        benchmarkVariant(report, "transpose", "sse2", transposeNanoseconds, [&]()
+        {
+            for (size_t i = 0; i < batchMatrixCount; ++i)
+            {
+                batch.result[i] = batch.lhs[i];
+                transpose(batch.result[i]);
+            }
+        });
+#endif
+        benchmarkVariant(report, "transpose", "directxmath", transposeNanoseconds, [&]()
+        {
+            for (size_t i = 0; i < batchMatrixCount; ++i)
+            {
+                const DirectX::XMMATRIX xmMatrix = DirectX::XMLoadFloat4x4(&batch.xmLhs[i]);
+                DirectX::XMStoreFloat4x4(&batch.xmResult[i], DirectX::XMMatrixTranspose(xmMatrix));
+            }
+        });
+        std::printf("%10s %12s %14g\n", "transpose", "max diff", calculateMaxDifference(batch));
+
+        const double inverseNanoseconds = benchmarkVariant(report, "inverse", "generic", 0.0, [&]()
+        {
+            for (size_t i = 0; i < batchMatrixCount; ++i)
+            {
+                batch.result[i] = inverse<float, 4>(batch.lhs[i]);
+            }
+        });
+#if defined(MATRIX_SSE2)
+        benchmarkVariant(report, "inverse", "sse2", inverseNanoseconds, [&]()
+        {
+            for (size_t i = 0; i < batchMatrixCount; ++i)
+            {
+                batch.result[i] = inverse(batch.lhs[i]);
+            }
+        });
+#endif
+        benchmarkVariant(report, "inverse", "directxmath", inverseNanoseconds, [&]()
+        {
+            for (size_t i = 0; i < batchMatrixCount; ++i)
+            {
+                const DirectX::XMMATRIX xmMatrix = DirectX::XMLoadFloat4x4(&batch.xmLhs[i]);
+                DirectX::XMStoreFloat4x4(&batch.xmResult[i], DirectX::XMMatrixInverse(nullptr, xmMatrix));
+            }
+        });
+        std::printf("%10s %12s %14g\n", "inverse", "max diff", calculateMaxDifference(batch));
+    }
+
+    // Times the per element DirectXMath loop the demos use against the batched TransformUtil version, on one thread
+    // and on the default thread count. Prints ns per element and speedups over DirectXMath.
+    template <typename DirectXMathFunc, typename BatchedFunc>
+    void benchmarkTransform(BenchmarkUtil::Report& report, const char* const operationName, const size_t count, const DirectXMathFunc& directXMathFunc, const BatchedFunc& batchedFunc)
+    {
+        const BenchmarkUtil::Result directXMathResult = BenchmarkUtil::measure(directXMathFunc);
+        const BenchmarkUtil::Result singleThreadResult = BenchmarkUtil::measure([&]() { batchedFunc(size_t(1u)); });
+        const BenchmarkUtil::Result result = BenchmarkUtil::measure([&]() { batchedFunc(size_t(0u)); });
+
+        const double nanosecondsPerMillisecond = 1.0e6 / static_cast<double>(count);
+        std::printf("%18s %10zu %12.3f %12.3f %12.3f %8.2fx %8.2fx\n", operationName, count, directXMathResult.medianMilliseconds * nanosecondsPerMillisecond,
+            singleThreadResult.medianMilliseconds * nanosecondsPerMillisecond, result.medianMilliseconds * nanosecondsPerMillisecond,
+            directXMathResult.medianMilliseconds / singleThreadResult.medianMilliseconds, directXMathResult.medianMilliseconds / result.medianMilliseconds);
+
+        const std::string name = std::string(operationName) + "/count:" + std::to_string(count);
+        report.add(name + "/variant:directxmath", directXMathResult);
+        report.add(name + "/variant:batched/threads:1", singleThreadResult);
+        report.add(name + "/variant:batched/threads:auto", result);
+    }
+
+    void benchmarkTransformCount(BenchmarkUtil::Report& report, const size_t count)
+    {
+        std::mt19937 generator(42u);
+        std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+        std::vector<DirectX::XMFLOAT4X4> lhs(count);
+        std::vector<DirectX::XMFLOAT4X4> rhs(count);
+        std::vector<DirectX::XMFLOAT4X4> matrices(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            // dominant diagonals keep every matrix invertible
+            for (size_t row = 0; row < 4u; ++row)
+            {
+                for (size_t col = 0; col < 4u; ++col)
+                {
+                    lhs[i].m[row][col] = distribution(generator) + (row == col ? 4.0f : 0.0f);
+                    rhs[i].m[row][col] = distribution(generator) + (row == col ? 4.0f : 0.0f);
+                }
+            }
+        }
+        std::vector<DirectX::XMFLOAT3> points(count);
+        std::vector<DirectX::XMFLOAT3> transformedPoints(count);
+        for (DirectX::XMFLOAT3& point : points)
+        {
+            point = { distribution(generator), distribution(generator), distribution(generator) };
+        }
+        const DirectX::XMFLOAT4X4& matrix = rhs[0];
+        const DirectX::XMMATRIX xmMatrix = DirectX::XMLoadFloat4x4(&matrix);
+
+        benchmarkTransform(report, "multiply", count, [&]()
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                DirectX::XMStoreFloat4x4(&matrices[i], DirectX::XMMatrixMultiply(DirectX::XMLoadFloat4x4(&lhs[i]), DirectX::XMLoadFloat4x4(&rhs[i])));
+            }
+        }, [&](const size_t threadCount) { TransformUtil::multiplyMatrices(matrices.data(), lhs.data(), rhs.data(), count, threadCount); });
+
+        benchmarkTransform(report, "multiplyShared", count, [&]()
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                DirectX::XMStoreFloat4x4(&matrices[i], DirectX::XMMatrixMultiply(DirectX::XMLoadFloat4x4(&lhs[i]), xmMatrix));
+            }
+        }, [&](const size_t threadCount) { TransformUtil::multiplyMatrices(matrices.data(), lhs.data(), matrix, count, threadCount); });
+
+        benchmarkTransform(report, "inverseTranspose", count, [&]()
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                DirectX::XMStoreFloat4x4(&matrices[i], DirectX::XMMatrixTranspose(DirectX::XMMatrixInverse(nullptr, DirectX::XMLoadFloat4x4(&lhs[i]))));
+            }
+        }, [&](const size_t threadCount) { TransformUtil::inverseTransposeMatrices(matrices.data(), lhs.data(), count, threadCount); });
+
+        benchmarkTransform(report, "transformPoints", count, [&]()
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                DirectX::XMStoreFloat3(&transformedPoints[i], DirectX::XMVector3Transform(DirectX::XMLoadFloat3(&points[i]), xmMatrix));
+            }
+        }, [&](const size_t threadCount) { TransformUtil::transformPoints(transformedPoints.data(), points.data(), count, matrix, threadCount); });
+
+        benchmarkTransform(report, "transformNormals", count, [&]()
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                DirectX::XMStoreFloat3(&transformedPoints[i], DirectX::XMVector3TransformNormal(DirectX::XMLoadFloat3(&points[i]), xmMatrix));
+            }
+        }, [&](const size_t threadCount) { TransformUtil::transformNormals(transformedPoints.data(), points.data(), count, matrix, threadCount); });
+    }
+
+    void benchmarkTransforms(BenchmarkUtil::Report& report)
+    {
+        std::printf("TransformUtil batches, %s kernels\n", TransformUtil::isAvx2Supported() ? "AVX2" : "fallback");
+        std::printf("%18s %10s %12s %12s %12s %9s %9s\n", "operation", "count", "dxm [ns]", "1 thread", "threads", "speedup", "threaded");
+        for (const size_t count : { size_t(1000u), size_t(100000u), size_t(1000000u) })
+        {
+            benchmarkTransformCount(report, count);
+        }
+    }
+
+    // the i-j-k loop operator* used before blocking, walks down a column of rhs for every element
+    template <typename T, size_t N>
+    void multiplyNaive(const Matrix<T, N>& lhs, const Matrix<T, N>& rhs, Matrix<T, N>& product)
+    {
+        for (size_t row = 0; row < N; ++row)
+        {
+            for (size_t col = 0; col < N; ++col)
+            {
+                T element = static_cast<T>(0);
+                for (size_t i = 0; i < N; ++i)
+                {
+                    element += lhs[row][i] * rhs[i][col];
+                }
+                product[row][col] = element;
+            }
+        }
+    }
+
+    template <typename T, size_t N>
+    void transposeNaive(const Matrix<T, N>& matrix, Matrix<T, N>& transposed)
+    {
+        for (size_t row = 0; row < N; ++row)
+        {
+            for (size_t col = 0; col < N; ++col)
+            {
+                transposed[col][row] = matrix[row][col];
+            }
+        }
+    }
+
+    template <size_t N>
+    void benchmarkLargeMatrixSize(BenchmarkUtil::Report& report)
+    {
+        using LargeMatrix = Matrix<double, N>;
+
+        // hundreds of rows do not fit on the stack
+        std::unique_ptr<LargeMatrix> pLhs = std::make_unique<LargeMatrix>();
+        std::unique_ptr<LargeMatrix> pRhs = std::make_unique<LargeMatrix>();
+        std::unique_ptr<LargeMatrix> pProduct = std::make_unique<LargeMatrix>();
+        std::mt19937 generator(42u);
+        std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+        for (size_t row = 0; row < N; ++row)
+        {
+            for (size_t col = 0; col < N; ++col)
+            {
+                (*pLhs)[row][col] = distribution(generator);
+                (*pRhs)[row][col] = distribution(generator);
+            }
+        }
+
+        const double flopCount = 2.0 * static_cast<double>(N) * static_cast<double>(N) * static_cast<double>(N);
+        const auto benchmarkMultiply = [&](const char* const variantName, const auto& func)
+        {
+            const BenchmarkUtil::Result result = BenchmarkUtil::measure(func);
+            const double gflops = flopCount / (result.medianMilliseconds * 1.0e6);
+            std::printf("%10s %6zu %16s %12.3f %10.2f\n", "multiply", N, variantName, result.medianMilliseconds, gflops);
+            report.add("largeMultiply/n:" + std::to_string(N) + "/variant:" + variantName, result, { { "gflops", gflops } });
+        };
+        benchmarkMultiply("naive", [&]() { multiplyNaive(*pLhs, *pRhs, *pProduct); });
+        benchmarkMultiply("blocked", [&]() { multiply(*pLhs, *pRhs, *pProduct, 1u); });
+        benchmarkMultiply("blocked threads", [&]() { multiply(*pLhs, *pRhs, *pProduct); });
+
+        // reads and writes every element once
+        const double byteCount = 2.0 * static_cast<double>(N) * static_cast<double>(N) * sizeof(double);
+        const auto benchmarkTranspose = [&](const char* const variantName, const auto& func)
+        {
+            const BenchmarkUtil::Result result = BenchmarkUtil::measure(func);
+            const double gigabytesPerSecond = byteCount / (result.medianMilliseconds * 1.0e6);
+            std::printf("%10s %6zu %16s %12.3f %10.2f\n", "transpose", N, variantName, result.medianMilliseconds, gigabytesPerSecond);
+            report.add("largeTranspose/n:" + std::to_string(N) + "/variant:" + variantName, result, { { "gigabytesPerSecond", gigabytesPerSecond } });
+        };
+        benchmarkTranspose("naive", [&]() { transposeNaive(*pLhs, *pProduct); });
+        benchmarkTranspose("blocked", [&]() { transpose(*pLhs, *pProduct); });
+        benchmarkTranspose("blocked inplace", [&]() { transpose(*pLhs); });
+    }
+
+    void benchmarkLargeMatrices(BenchmarkUtil::Report& report)
+    {
+        std::printf("Matrix<double, N> multiply [GFLOP/s] and transpose [GB/s]\n");
+        std::printf("%10s %6s %16s %12s %10s\n", "operation", "n", "variant", "median [ms]", "rate");
+        benchmarkLargeMatrixSize<64u>(report);
+        benchmarkLargeMatrixSize<128u>(report);
+        benchmarkLargeMatrixSize<256u>(report);
+        benchmarkLargeMatrixSize<512u>(report);
+        benchmarkLargeMatrixSize<1024u>(report);
+    }
+
+    // Times the cofactor expansion against the closed forms and the LU decomposition and counts the allocations of one
+    // call, which has to be 0. Returns the number of allocations.
+    template <size_t N>
+    size_t benchmarkCofactorSize(BenchmarkUtil::Report& report)
+    {
+        // a few different matrices so the compiler cannot hoist the calls out of the loops, enough for timing N = 3
+        constexpr size_t matrixCount = 64u;
+
+        std::mt19937 generator(42u);
+        std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+        std::vector<Matrix<double, N>> matrices(matrixCount);
+        std::vector<Matrix<double, N>> cofactorResults(matrixCount);
+        std::vector<Matrix<double, N>> results(matrixCount);
+        for (Matrix<double, N>& matrix : matrices)
+        {
+            for (size_t row = 0; row < N; ++row)
+            {
+                for (size_t col = 0; col < N; ++col)
+                {
+                    matrix[row][col] = distribution(generator) + (row == col ? static_cast<double>(N) : 0.0);
+                }
+            }
+        }
+
+        size_t totalAllocationCount = 0u;
+        const auto benchmarkOperation = [&](const char* const operationName, const char* const variantName, std::vector<Matrix<double, N>>& dst, const auto& func)
+        {
+            const size_t allocationCountBefore = allocationCount;
+            dst[0] = func(matrices[0]);
+            const size_t callAllocationCount = allocationCount - allocationCountBefore;
+            totalAllocationCount += callAllocationCount;
+
+            const BenchmarkUtil::Result result = BenchmarkUtil::measure([&]()
+            {
+                for (size_t i = 0; i < matrixCount; ++i)
+                {
+                    dst[i] = func(matrices[i]);
+                }
+            });
+            const double nanoseconds = result.medianMilliseconds * 1.0e6 / static_cast<double>(matrixCount);
+            std::printf("%10s %4zu %10s %14.1f %8zu\n", operationName, N, variantName, nanoseconds, callAllocationCount);
+            report.add(std::string("cofactor/") + operationName + "/n:" + std::to_string(N) + "/variant:" + variantName, result,
+                { { "nanosecondsPerMatrix", nanoseconds }, { "allocations", static_cast<double>(callAllocationCount) } });
+        };
+
+        // the relative difference, the elements grow quickly with N
+        const auto printMaxDifference = [&](const char* const operationName)
+        {
+            double maxDifference = 0.0;
+            for (size_t i = 0; i < matrixCount; ++i)
+            {
+                for (size_t row = 0; row < N; ++row)
+                {
+                    for (size_t col = 0; col < N; ++col)
+                    {
+                        const double difference = std::abs(cofactorResults[i][row][col] - results[i][row][col]);
+                        maxDifference = std::max(maxDifference, difference / std::max(std::abs(results[i][row][col]), 1.0));
+                    }
+                }
+            }
+            std::printf("%10s %4zu %10s %14g\n", operationName, N, "max diff", maxDifference);
+        };
+
+        benchmarkOperation("adjugate", "cofactor", cofactorResults, [](const Matrix<double, N>& matrix) { return adjugate_cofactor(matrix); });
+        benchmarkOperation("adjugate", "default", results, [](const Matrix<double, N>& matrix) { return adjugate(matrix); });
+        printMaxDifference("adjugate");
+        benchmarkOperation("inverse", "cofactor", cofactorResults, [](const Matrix<double, N>& matrix) { return inverse_cofactor(matrix); });
+        benchmarkOperation("inverse", "default", results, [](const Matrix<double, N>& matrix) { return inverse(matrix); });
+        printMaxDifference("inverse");
+        return totalAllocationCount;
+    }
+
+    // default is the closed form up to 4x4 and the LU decomposition above
+    size_t benchmarkCofactor(BenchmarkUtil::Report& report)
+    {
+        std::printf("Matrix<double, N> cofactor expansion, allocations per call\n");
+        std::printf("%10s %4s %10s %14s %8s\n", "operation", "n", "variant", "ns/matrix", "allocs");
+        size_t cofactorAllocationCount = benchmarkCofactorSize<3u>(report);
+        cofactorAllocationCount += benchmarkCofactorSize<4u>(report);
+        cofactorAllocationCount += benchmarkCofactorSize<5u>(report);
+        cofactorAllocationCount += benchmarkCofactorSize<6u>(report);
+        cofactorAllocationCount += benchmarkCofactorSize<7u>(report);
+        cofactorAllocationCount += benchmarkCofactorSize<8u>(report);
+        return cofactorAllocationCount;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    // --json <path> additionally writes every measurement to a JSON file for comparing runs
+    const char* jsonPath = nullptr;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+        {
+            jsonPath = argv[++i];
+        }
+        else
+        {
+            std::fprintf(stderr, "usage: %s [--json <path>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    BenchmarkUtil::Report report;
+    report.addContext("hardwareThreads", static_cast<double>(ThreadUtil::getDefaultThreadCount()));
+    report.addContext("avx2", TransformUtil::isAvx2Supported() ? 1.0 : 0.0);
+
+    benchmarkMatrix4(report);
+    benchmarkTransforms(report);
+    benchmarkLargeMatrices(report);
+    const size_t cofactorAllocationCount = benchmarkCofactor(report);
+
+    if (jsonPath != nullptr && !report.writeJson(jsonPath))
+    {
+        std::fprintf(stderr, "could not write %s\n", jsonPath);
+        return 1;
+    }
+    if (cofactorAllocationCount > 0u)
+    {
+        std::fprintf(stderr, "the cofactor expansion allocated %zu times\n", cofactorAllocationCount);
+        return 1;
+    }
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,150 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "BenchmarkUtil.h"
+#include "ProfileUtil.h"
+#include "TimeUtil.h"
+#include "Timer.h"
+
+namespace
+{
+    // enough calls per iteration that the overhead of measure itself does not matter
+    constexpr size_t callCount = size_t(1u) << 20u;
+
+    // keeps the compiler from dropping the reads
+    volatile int64_t s_sink = 0;
+
+    const char* getTimeSourceName(const TimeUtil::TimeSource timeSource)
+    {
+        switch (timeSource)
+        {
+        case TimeUtil::TimeSource::Tsc:
+            return "tsc";
+        case TimeUtil::TimeSource::Monotonic:
+            return "monotonic";
+        default:
+            return "steady_clock";
+        }
+    }
+
+    // prints and reports the time per call
+    template <typename Func>
+    void benchmarkCall(BenchmarkUtil::Report& report, const char* const operationName, const char* const variantName, const Func& func)
+    {
+        const BenchmarkUtil::Result result = BenchmarkUtil::measure([&]()
+        {
+            int64_t sum = 0;
+            for (size_t i = 0; i < callCount; ++i)
+            {
+                sum += func();
+            }
+            s_sink = sum;
+        });
+        const double nanoseconds = result.medianMilliseconds * 1.0e6 / static_cast<double>(callCount);
+        std::printf("%12s %20s %10.2f\n", operationName, variantName, nanoseconds);
+        report.add(std::string(operationName) + "/variant:" + variantName, result, { { "nanosecondsPerCall", nanoseconds } });
+    }
+
+    void benchmarkTimeSources(BenchmarkUtil::Report& report)
+    {
+        std::printf("time sources, default %s, invariant TSC %s\n", getTimeSourceName(TimeUtil::getDefaultTimeSource()), TimeUtil::isInvariantTscSupported() ? "yes" : "no");
+        std::printf("%12s %20s %10s\n", "operation", "variant", "ns/call");
+
+        benchmarkCall(report, "read", "tsc", []() { return TimeUtil::readTscTicks(); });
+        benchmarkCall(report, "read", "monotonic", []() { return TimeUtil::readMonotonicTicks(); });
+        benchmarkCall(report, "read", "steady_clock", []() { return TimeUtil::readSteadyClockTicks(); });
+        // what Timer read before the time sources
+        benchmarkCall(report, "read", "high_resolution_clock", []()
+        {
+            return static_cast<int64_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+        });
+        benchmarkCall(report, "read", "default", []() { return TimeUtil::getTicks(); });
+
+        for (const TimeUtil::TimeSource timeSource : { TimeUtil::TimeSource::Tsc, TimeUtil::TimeSource::Monotonic, TimeUtil::TimeSource::SteadyClock })
+        {
+            Timer timer(timeSource);
+            timer.reset();
+            timer.start();
+            benchmarkCall(report, "Timer::tick", getTimeSourceName(timeSource), [&]()
+            {
+                timer.tick();
+                return static_cast<int64_t>(timer.getDelta() > 0.0f);
+            });
+        }
+
+        ProfileUtil::setEnabled(false);
+        benchmarkCall(report, "zone", "disabled", []()
+        {
+            PROFILE_ZONE("time-bench zone");
+            return int64_t(0);
+        });
+        ProfileUtil::setEnabled(true);
+        benchmarkCall(report, "zone", "enabled", []()
+        {
+            PROFILE_ZONE("time-bench zone");
+            return int64_t(0);
+        });
+        ProfileUtil::setEnabled(false);
+        ProfileUtil::clear();
+    }
+
+    // compares each source with steady_clock over an interval much longer than the TSC calibration
+    void benchmarkCalibration(BenchmarkUtil::Report& report)
+    {
+        std::printf("calibration over 200 ms\n");
+        std::printf("%12s %16s %14s\n", "source", "ticks/s", "rel. error");
+        for (const TimeUtil::TimeSource timeSource : { TimeUtil::TimeSource::Tsc, TimeUtil::TimeSource::Monotonic })
+        {
+            using clock_type = std::chrono::steady_clock;
+            const clock_type::time_point start = clock_type::now();
+            const int64_t startTicks = TimeUtil::getTicks(timeSource);
+            clock_type::time_point end;
+            do
+            {
+                end = clock_type::now();
+            } while (end - start < std::chrono::milliseconds(200));
+            const int64_t endTicks = TimeUtil::getTicks(timeSource);
+
+            const double ticksPerSecond = TimeUtil::getTicksPerSecond(timeSource);
+            const double seconds = static_cast<double>(endTicks - startTicks) / ticksPerSecond;
+            const double relativeError = std::abs(seconds / std::chrono::duration<double>(end - start).count() - 1.0);
+            std::printf("%12s %16.0f %14.2e\n", getTimeSourceName(timeSource), ticksPerSecond, relativeError);
+            report.addContext((std::string(getTimeSourceName(timeSource)) + "TicksPerSecond").c_str(), ticksPerSecond);
+            report.addContext((std::string(getTimeSourceName(timeSource)) + "RelativeError").c_str(), relativeError);
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    // --json <path> additionally writes every measurement to a JSON file for comparing runs
+    const char* jsonPath = nullptr;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+        {
+            jsonPath = argv[++i];
+        }
+        else
+        {
+            std::fprintf(stderr, "usage: %s [--json <path>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    BenchmarkUtil::Report report;
+    report.addContext("invariantTsc", TimeUtil::isInvariantTscSupported() ? 1.0 : 0.0);
+
+    benchmarkTimeSources(report);
+    benchmarkCalibration(report);
+
+    if (jsonPath != nullptr && !report.writeJson(jsonPath))
+    {
+        std::fprintf(stderr, "could not write %s\n", jsonPath);
+        return 1;
+    }
+    return 0;
+}
\ No newline at end of file
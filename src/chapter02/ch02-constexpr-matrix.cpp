@@ -0,0 +1,102 @@
+#include <iostream>
+
+#include "matrix.h"
+
+// std::array's operator== only becomes constexpr in C++20
+template <typename T, size_t N>
+constexpr bool equal(const Matrix<T, N> &lhs, const Matrix<T, N> &rhs, const T tolerance = static_cast<T>(0))
+{
+    for (size_t row = 0; row < N; ++row)
+    {
+        for (size_t col = 0; col < N; ++col)
+        {
+            if (constexpr_abs(lhs[row][col] - rhs[row][col]) > tolerance)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+template <typename T, size_t N>
+constexpr Matrix<T, N> transposed(Matrix<T, N> matrix)
+{
+    transpose(matrix);
+    return matrix;
+}
+
+template <typename T, size_t N>
+constexpr Matrix<T, N> identity()
+{
+    Matrix<T, N> matrix = {};
+    for (size_t i = 0; i < N; ++i)
+    {
+        matrix[i][i] = static_cast<T>(1);
+    }
+    return matrix;
+}
+
+// every matrix below is computed by the compiler, the static_asserts fail to compile otherwise
+
+// reflection about the z = 0 plane, like the mirror of chapter 11
+constexpr Matrix4<float> mirror = { {
+    {1.0f, 0.0f, 0.0f, 0.0f},
+    {0.0f, 1.0f, 0.0f, 0.0f},
+    {0.0f, 0.0f, -1.0f, 0.0f},
+    {0.0f, 0.0f, 0.0f, 1.0f},
+} };
+
+// row vector convention, the translation is in the last row
+constexpr Matrix4<float> translation = { {
+    {1.0f, 0.0f, 0.0f, 0.0f},
+    {0.0f, 1.0f, 0.0f, 0.0f},
+    {0.0f, 0.0f, 1.0f, 0.0f},
+    {0.0f, 0.0f, -4.0f, 1.0f},
+} };
+
+// orthographic projection of [-8, 8] x [-4.5, 4.5] x [0.5, 100.5] to [-1, 1] x [-1, 1] x [0, 1]
+constexpr Matrix4<float> projection = { {
+    {0.125f, 0.0f, 0.0f, 0.0f},
+    {0.0f, 1.0f / 4.5f, 0.0f, 0.0f},
+    {0.0f, 0.0f, 0.01f, 0.0f},
+    {0.0f, 0.0f, -0.005f, 1.0f},
+} };
+
+constexpr Matrix4<float> mirrorWorld = translation * mirror;
+constexpr Matrix4<float> mirrorWorldInverse = inverse(mirrorWorld);
+constexpr Matrix4<float> mirrorWorldProjection = mirrorWorld * projection;
+
+static_assert(determinant(mirror) == -1.0f, "a reflection flips the orientation");
+static_assert(equal(inverse(mirror), mirror), "a reflection is its own inverse");
+static_assert(equal(transposed(transposed(projection)), projection), "transposing twice is the identity");
+static_assert(mirrorWorld[3][2] == 4.0f, "the mirror flips the translation");
+static_assert(equal(mirrorWorld * mirrorWorldInverse, identity<float, 4>()), "exact for these matrices");
+static_assert(equal(inverse(projection) * projection, identity<float, 4>(), 1e-6f), "projection round trip");
+
+// above 4x4 determinant and inverse go through the LU decomposition, which is constexpr as well
+constexpr Matrix<double, 5> tridiagonal = { {
+    {2.0, -1.0, 0.0, 0.0, 0.0},
+    {-1.0, 2.0, -1.0, 0.0, 0.0},
+    {0.0, -1.0, 2.0, -1.0, 0.0},
+    {0.0, 0.0, -1.0, 2.0, -1.0},
+    {0.0, 0.0, 0.0, -1.0, 2.0},
+} };
+
+static_assert(constexpr_abs(determinant(tridiagonal) - 6.0) < 1e-12, "the determinant of this N x N matrix is N + 1");
+static_assert(equal(tridiagonal * inverse(tridiagonal), identity<double, 5>(), 1e-12), "LU inverse");
+
+int main()
+{
+    // the matrices are constants in the binary, printing only needs copies since operator<< takes references
+    Matrix4<float> m = mirrorWorldProjection;
+    std::cout << m << "\n";
+
+    m = mirrorWorldInverse;
+    std::cout << m << "\n";
+
+    Matrix<double, 5> m5 = inverse(tridiagonal);
+    std::cout << m5 << "\n";
+
+    return 0;
+}
\ No newline at end of file
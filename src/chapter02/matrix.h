@@ -1,16 +1,32 @@
 #include <cassert>
+#include <algorithm>
 #include <array>
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <type_traits>
 #include <vector>
 #include <ostream>
 
-template <typename T, size_t N>
-using Matrix = std::array<std::array<T, N>, N>;
+// The SSE2 overloads below stay usable in constant expressions by falling back to the generic templates during
+// constant evaluation, which C++17 can only detect with this builtin.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#if (defined(__GNUC__) && __GNUC__ >= 9) || (defined(__clang__) && __clang_major__ >= 9) || (defined(_MSC_VER) && _MSC_VER >= 1925)
+#define MATRIX_SSE2 1
+#include <emmintrin.h>
+#endif
+#endif
+
+// R rows of C columns, square unless C is given. Matrices in the hundreds of rows do not fit on the stack, keep them on
+// the heap, e.g. with std::make_unique, and use multiply and the two argument transpose, which write to a given matrix.
+template <typename T, size_t R, size_t C = R>
+using Matrix = std::array<std::array<T, C>, R>;
 
 template <typename T>
 using Matrix4 = Matrix<T, 4>;
 
-template <typename T, size_t N>
-std::ostream& operator<<(std::ostream &o, Matrix<T, N> &matrix)
+template <typename T, size_t R, size_t C>
+std::ostream& operator<<(std::ostream &o, Matrix<T, R, C> &matrix)
 {
     for (const auto &row : matrix)
     {
@@ -25,53 +41,118 @@ std::ostream& operator<<(std::ostream &o, Matrix<T, N> &matrix)
     return o;
 }
 
+// std::swap and std::abs only become constexpr in C++20 and C++23
+template <typename T>
+constexpr void constexpr_swap(T &lhs, T &rhs)
+{
+    T temp = lhs;
+    lhs = rhs;
+    rhs = temp;
+}
+
+template <typename T>
+constexpr T constexpr_abs(const T &value)
+{
+    return value < static_cast<T>(0) ? -value : value;
+}
+
+// Edge length of the square tiles transpose and multiply work on. Three tiles of doubles take 24 KiB, so the tiles a
+// loop nest touches stay in L1 instead of striding through whole columns.
+constexpr size_t matrix_block_size = 32;
+
 template <typename T, size_t N>
-void transpose(Matrix<T, N>& matrix)
+constexpr void transpose(Matrix<T, N>& matrix)
 {
-    for (size_t row = 0; row < N - 1; ++row)
+    // tiles above the diagonal swap with their mirror tiles below it, column walks stay within a tile
+    for (size_t row_block = 0; row_block < N; row_block += matrix_block_size)
     {
-        // swapping is symmetrical so we only need to process half of the matrix => col = row
-        // main diagonal stays untouched => col = row + 1
-        for (size_t col = row + 1; col < N; ++col)
+        const size_t row_end = std::min(row_block + matrix_block_size, N);
+        for (size_t col_block = row_block; col_block < N; col_block += matrix_block_size)
         {
-            std::swap(matrix[row][col], matrix[col][row]);
+            const size_t col_end = std::min(col_block + matrix_block_size, N);
+            for (size_t row = row_block; row < row_end; ++row)
+            {
+                // swapping is symmetrical so we only need to process half of the matrix => col = row
+                // main diagonal stays untouched => col = row + 1
+                for (size_t col = std::max(col_block, row + 1); col < col_end; ++col)
+                {
+                    constexpr_swap(matrix[row][col], matrix[col][row]);
+                }
+            }
         }
     }
 }
 
+// out of place and for any shape, transposed must not alias matrix
+template <typename T, size_t R, size_t C>
+constexpr void transpose(const Matrix<T, R, C> &matrix, Matrix<T, C, R> &transposed)
+{
+    for (size_t row_block = 0; row_block < R; row_block += matrix_block_size)
+    {
+        const size_t row_end = std::min(row_block + matrix_block_size, R);
+        for (size_t col_block = 0; col_block < C; col_block += matrix_block_size)
+        {
+            const size_t col_end = std::min(col_block + matrix_block_size, C);
+            for (size_t row = row_block; row < row_end; ++row)
+            {
+                for (size_t col = col_block; col < col_end; ++col)
+                {
+                    transposed[col][row] = matrix[row][col];
+                }
+            }
+        }
+    }
+}
+
+// Rows and columns the cofactor recursion has excluded, bit i stands for row or column i. Fixed size state instead of
+// lists keeps the recursion free of allocations and searches.
+using exclude_mask = uint64_t;
+
+constexpr size_t count_excluded(exclude_mask mask)
+{
+    size_t count = 0;
+    for (; mask != 0; mask &= mask - 1)
+    {
+        ++count;
+    }
+    return count;
+}
+
+constexpr bool is_excluded(const exclude_mask mask, const size_t index)
+{
+    return ((mask >> index) & 1u) != 0;
+}
+
+// determinant of the minor without the rows and columns in row_exclude and col_exclude, which exclude equally many
 template <typename T, size_t N>
-T sub_determinant(Matrix<T, N> &matrix, std::vector<size_t>& row_exclude, std::vector<size_t>& col_exclude)
+constexpr T sub_determinant(const Matrix<T, N> &matrix, const exclude_mask row_exclude, const exclude_mask col_exclude)
 {
-    assert(row_exclude.size() == col_exclude.size());
-    if (row_exclude.size() < N - 2)
+    static_assert(N <= sizeof(exclude_mask) * 8, "exclude masks have one bit per row and column");
+    assert(count_excluded(row_exclude) == count_excluded(col_exclude));
+
+    const size_t size = N - count_excluded(row_exclude);
+    if (size > 2)
     {
         T determinant = static_cast<T>(0);
         T sign = static_cast<T>(1);
 
-        for (size_t row = 0; row < N; ++row)
+        // expand along the first remaining row
+        size_t row = 0;
+        while (is_excluded(row_exclude, row))
         {
-            if (std::find(row_exclude.begin(), row_exclude.end(), row) == row_exclude.end())
-            {
-                row_exclude.push_back(row);
-                break;
-            }
+            ++row;
         }
 
         for (size_t col = 0; col < N; ++col)
         {
-            if (std::find(col_exclude.begin(), col_exclude.end(), col) != col_exclude.end())
+            if (is_excluded(col_exclude, col))
             {
                 continue;
             }
 
-            col_exclude.push_back(col);
-
-            determinant += sign * matrix[row_exclude.back()][col] * sub_determinant(matrix, row_exclude, col_exclude);
+            determinant += sign * matrix[row][col] * sub_determinant(matrix, row_exclude | (exclude_mask(1) << row), col_exclude | (exclude_mask(1) << col));
             sign *= static_cast<T>(-1);
-
-            col_exclude.pop_back();
         }
-        row_exclude.pop_back();
         return determinant;
     }
     else
@@ -79,9 +160,9 @@ T sub_determinant(Matrix<T, N> &matrix, std::vector<size_t>& row_exclude, std::v
         size_t rows[2] = {};
         size_t cols[2] = {};
 
-        for (size_t col = 0, i = 0; col < N; ++col)
+        for (size_t col = 0, i = 0; col < N && i < size; ++col)
         {
-            if (std::find(col_exclude.begin(), col_exclude.end(), col) != col_exclude.end())
+            if (is_excluded(col_exclude, col))
             {
                 continue;
             }
@@ -89,9 +170,9 @@ T sub_determinant(Matrix<T, N> &matrix, std::vector<size_t>& row_exclude, std::v
             cols[i++] = col;
         }
 
-        for (size_t row = 0, i = 0; row < N; ++row)
+        for (size_t row = 0, i = 0; row < N && i < size; ++row)
         {
-            if (std::find(row_exclude.begin(), row_exclude.end(), row) != row_exclude.end())
+            if (is_excluded(row_exclude, row))
             {
                 continue;
             }
@@ -99,31 +180,33 @@ T sub_determinant(Matrix<T, N> &matrix, std::vector<size_t>& row_exclude, std::v
             rows[i++] = row;
         }
 
+        // adjugates of 2x2 matrices end up here with 1x1 minors
+        if (size == 1)
+        {
+            return matrix[rows[0]][cols[0]];
+        }
         return matrix[rows[0]][cols[0]] * matrix[rows[1]][cols[1]] - matrix[rows[0]][cols[1]] * matrix[rows[1]][cols[0]];
     }
 }
 
+// cofactor expansion, O(N!), kept as reference for determinant
 template <typename T, size_t N>
-T determinant(Matrix<T, N> &matrix)
+constexpr T determinant_cofactor(const Matrix<T, N> &matrix)
 {
-    std::vector<size_t> col_exclude;
-    std::vector<size_t> row_exclude;
-    return sub_determinant(matrix, row_exclude, col_exclude);
+    return sub_determinant(matrix, 0, 0);
 }
 
+// cofactor expansion, kept as reference for adjugate
 template <typename T, size_t N>
-Matrix<T, N> adjugate(Matrix<T, N> &matrix)
+constexpr Matrix<T, N> adjugate_cofactor(const Matrix<T, N> &matrix)
 {
-    Matrix<T, N> adjugate;
-    T sign;
+    Matrix<T, N> adjugate = {};
     for (size_t row = 0; row < N; ++row)
     {
-        sign = static_cast<T>(row % 2 == 0 ? 1 : -1);
+        T sign = static_cast<T>(row % 2 == 0 ? 1 : -1);
         for (size_t col = 0; col < N; ++col)
         {
-            std::vector<size_t> row_exclude = { row };
-            std::vector<size_t> col_exclude = { col };
-            adjugate[col][row] = sign * sub_determinant(matrix, row_exclude, col_exclude);;
+            adjugate[col][row] = sign * sub_determinant(matrix, exclude_mask(1) << row, exclude_mask(1) << col);
             sign = -sign;
         }
     }
@@ -131,56 +214,534 @@ Matrix<T, N> adjugate(Matrix<T, N> &matrix)
     return adjugate;
 }
 
-template <typename T, size_t N>
-Matrix<T, N>& operator*=(Matrix<T, N> &lhs, const T &rhs)
+template <typename T, size_t R, size_t C>
+constexpr Matrix<T, R, C>& operator*=(Matrix<T, R, C> &lhs, const T &rhs)
 {
-    for (size_t col = 0; col < N; ++col)
+    for (auto &row : lhs)
     {
-        for (size_t row = 0; row < N; ++row)
+        for (auto &element : row)
         {
-            lhs[row][col] *= rhs;
+            element *= rhs;
         }
     }
     return lhs;
 }
 
-template <typename T, size_t N>
-Matrix<T, N>& operator/=(Matrix<T, N> &lhs, const T &rhs)
+template <typename T, size_t R, size_t C>
+constexpr Matrix<T, R, C>& operator/=(Matrix<T, R, C> &lhs, const T &rhs)
 {
-    for (size_t col = 0; col < N; ++col)
+    for (auto &row : lhs)
     {
-        for (size_t row = 0; row < N; ++row)
+        for (auto &element : row)
         {
-            lhs[row][col] /= rhs;
+            element /= rhs;
         }
     }
     return lhs;
 }
 
-template <typename T, size_t N>
-Matrix<T, N> operator*(const Matrix<T, N> &lhs, const Matrix<T, N> &rhs)
+// Adds the rows [row_begin, row_end) of lhs * rhs to product. The innermost loop runs along rows of rhs and product
+// instead of down a column of rhs, and the K and C dimensions are split into tiles that stay in L1 while all rows of
+// the range use them.
+template <typename T, size_t R, size_t K, size_t C>
+constexpr void multiply_add_rows(const Matrix<T, R, K> &lhs, const Matrix<T, K, C> &rhs, Matrix<T, R, C> &product, const size_t row_begin, const size_t row_end)
 {
-    Matrix<T, N> product;
-    for (size_t row_l = 0; row_l < N; ++row_l)
+    for (size_t row_block = row_begin; row_block < row_end; row_block += matrix_block_size)
     {
-        for (size_t col_r = 0; col_r < N; ++col_r)
+        const size_t row_block_end = std::min(row_block + matrix_block_size, row_end);
+        for (size_t k_block = 0; k_block < K; k_block += matrix_block_size)
         {
-            T element = static_cast<T>(0);
-            for (size_t i = 0; i < N; ++i)
+            const size_t k_block_end = std::min(k_block + matrix_block_size, K);
+            for (size_t col_block = 0; col_block < C; col_block += matrix_block_size)
             {
-                element += lhs[row_l][i] * rhs[i][col_r];
+                const size_t col_block_end = std::min(col_block + matrix_block_size, C);
+                for (size_t row = row_block; row < row_block_end; ++row)
+                {
+                    // a local row segment cannot alias rhs, which lets compilers vectorize the loop over its columns
+                    std::array<T, matrix_block_size> accumulators = {};
+                    for (size_t k = k_block; k < k_block_end; ++k)
+                    {
+                        const T element = lhs[row][k];
+                        if (col_block_end - col_block == matrix_block_size)
+                        {
+                            for (size_t col = 0; col < matrix_block_size; ++col)
+                            {
+                                accumulators[col] += element * rhs[k][col_block + col];
+                            }
+                        }
+                        else
+                        {
+                            for (size_t col = 0; col < col_block_end - col_block; ++col)
+                            {
+                                accumulators[col] += element * rhs[k][col_block + col];
+                            }
+                        }
+                    }
+                    for (size_t col = col_block; col < col_block_end; ++col)
+                    {
+                        product[row][col] += accumulators[col - col_block];
+                    }
+                }
             }
-            product[row_l][col_r] = element;
         }
     }
+}
+
+template <typename T, size_t R, size_t K, size_t C>
+constexpr Matrix<T, R, C> operator*(const Matrix<T, R, K> &lhs, const Matrix<T, K, C> &rhs)
+{
+    Matrix<T, R, C> product = {};
+    multiply_add_rows(lhs, rhs, product, 0, R);
     return product;
 }
 
+// Writes lhs * rhs to product, which must not alias lhs or rhs. Row ranges go to thread_count threads, 0 picks one per
+// hardware thread once the product is large enough to pay for starting them.
+template <typename T, size_t R, size_t K, size_t C>
+void multiply(const Matrix<T, R, K> &lhs, const Matrix<T, K, C> &rhs, Matrix<T, R, C> &product, size_t thread_count = 0)
+{
+    assert(static_cast<const void*>(&product) != static_cast<const void*>(&lhs) && static_cast<const void*>(&product) != static_cast<const void*>(&rhs));
+
+    for (auto &row : product)
+    {
+        row.fill(static_cast<T>(0));
+    }
+
+    if (thread_count == 0)
+    {
+        constexpr size_t min_parallel_multiply_adds = size_t(1) << 21;
+        thread_count = R * K * C >= min_parallel_multiply_adds ? std::max(1u, std::thread::hardware_concurrency()) : 1;
+    }
+    // whole row blocks per thread, so no two threads write to the same tile
+    const size_t row_block_count = (R + matrix_block_size - 1) / matrix_block_size;
+    thread_count = std::min(thread_count, row_block_count);
+    if (thread_count <= 1)
+    {
+        multiply_add_rows(lhs, rhs, product, 0, R);
+        return;
+    }
+
+    const auto get_row_begin = [row_block_count, thread_count](const size_t thread)
+    {
+        return std::min(row_block_count * thread / thread_count * matrix_block_size, R);
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(thread_count - 1);
+    for (size_t thread = 1; thread < thread_count; ++thread)
+    {
+        threads.emplace_back([&, thread]() { multiply_add_rows(lhs, rhs, product, get_row_begin(thread), get_row_begin(thread + 1)); });
+    }
+    multiply_add_rows(lhs, rhs, product, 0, get_row_begin(1));
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+}
+
+// cofactor expansion, kept as reference for inverse
 template <typename T, size_t N>
-Matrix<T, N> inverse(Matrix<T, N> &matrix)
+constexpr Matrix<T, N> inverse_cofactor(const Matrix<T, N> &matrix)
 {
-    T det = determinant(matrix);
-    Matrix<T, N> adj = adjugate(matrix);
+    T det = determinant_cofactor(matrix);
+    Matrix<T, N> adj = adjugate_cofactor(matrix);
     adj /= det;
     return adj;
-}
\ No newline at end of file
+}
+
+// Doolittle decomposition with partial pivoting, in place: the strictly lower part of matrix becomes L (with an implicit
+// unit diagonal) and the upper part becomes U of the row swapped input. pivots receives the input row of every row.
+// Returns the sign of the row permutation, or 0 if the matrix is singular.
+template <typename T, size_t N>
+constexpr T lu_decompose(Matrix<T, N> &matrix, std::array<size_t, N> &pivots)
+{
+    static_assert(std::is_floating_point_v<T>, "lu_decompose divides by pivots, use a floating point type");
+
+    T sign = static_cast<T>(1);
+    for (size_t row = 0; row < N; ++row)
+    {
+        pivots[row] = row;
+    }
+
+    for (size_t col = 0; col < N; ++col)
+    {
+        // the largest remaining element of the column as pivot keeps the multipliers at most 1
+        size_t pivot = col;
+        for (size_t row = col + 1; row < N; ++row)
+        {
+            if (constexpr_abs(matrix[row][col]) > constexpr_abs(matrix[pivot][col]))
+            {
+                pivot = row;
+            }
+        }
+        if (matrix[pivot][col] == static_cast<T>(0))
+        {
+            return static_cast<T>(0);
+        }
+        if (pivot != col)
+        {
+            for (size_t i = 0; i < N; ++i)
+            {
+                constexpr_swap(matrix[pivot][i], matrix[col][i]);
+            }
+            constexpr_swap(pivots[pivot], pivots[col]);
+            sign = -sign;
+        }
+
+        const T inv_pivot = static_cast<T>(1) / matrix[col][col];
+        for (size_t row = col + 1; row < N; ++row)
+        {
+            const T factor = matrix[row][col] * inv_pivot;
+            matrix[row][col] = factor;
+            for (size_t i = col + 1; i < N; ++i)
+            {
+                matrix[row][i] -= factor * matrix[col][i];
+            }
+        }
+    }
+    return sign;
+}
+
+// solves matrix * x = b in place of b, with lu and pivots from lu_decompose of matrix
+template <typename T, size_t N>
+constexpr void lu_solve(const Matrix<T, N> &lu, const std::array<size_t, N> &pivots, std::array<T, N> &b)
+{
+    std::array<T, N> x = {};
+    for (size_t row = 0; row < N; ++row)
+    {
+        // forward substitution with L
+        T element = b[pivots[row]];
+        for (size_t i = 0; i < row; ++i)
+        {
+            element -= lu[row][i] * x[i];
+        }
+        x[row] = element;
+    }
+    for (size_t row = N; row-- > 0;)
+    {
+        // back substitution with U
+        T element = x[row];
+        for (size_t i = row + 1; i < N; ++i)
+        {
+            element -= lu[row][i] * x[i];
+        }
+        x[row] = element / lu[row][row];
+    }
+    b = x;
+}
+
+// closed form up to 4x4, O(N^3) LU decomposition above
+template <typename T, size_t N>
+constexpr T determinant(const Matrix<T, N> &matrix)
+{
+    const Matrix<T, N> &m = matrix;
+    if constexpr (N == 1)
+    {
+        return m[0][0];
+    }
+    else if constexpr (N == 2)
+    {
+        return m[0][0] * m[1][1] - m[0][1] * m[1][0];
+    }
+    else if constexpr (N == 3)
+    {
+        return m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1])
+            - m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0])
+            + m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+    }
+    else if constexpr (N == 4)
+    {
+        // 2x2 sub-determinants of the upper and lower two rows, shared with adjugate
+        const T s0 = m[0][0] * m[1][1] - m[1][0] * m[0][1];
+        const T s1 = m[0][0] * m[1][2] - m[1][0] * m[0][2];
+        const T s2 = m[0][0] * m[1][3] - m[1][0] * m[0][3];
+        const T s3 = m[0][1] * m[1][2] - m[1][1] * m[0][2];
+        const T s4 = m[0][1] * m[1][3] - m[1][1] * m[0][3];
+        const T s5 = m[0][2] * m[1][3] - m[1][2] * m[0][3];
+        const T c0 = m[2][0] * m[3][1] - m[3][0] * m[2][1];
+        const T c1 = m[2][0] * m[3][2] - m[3][0] * m[2][2];
+        const T c2 = m[2][0] * m[3][3] - m[3][0] * m[2][3];
+        const T c3 = m[2][1] * m[3][2] - m[3][1] * m[2][2];
+        const T c4 = m[2][1] * m[3][3] - m[3][1] * m[2][3];
+        const T c5 = m[2][2] * m[3][3] - m[3][2] * m[2][3];
+        return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+    }
+    else
+    {
+        Matrix<T, N> lu = matrix;
+        std::array<size_t, N> pivots = {};
+        T det = lu_decompose(lu, pivots);
+        for (size_t i = 0; i < N; ++i)
+        {
+            det *= lu[i][i];
+        }
+        return det;
+    }
+}
+
+// closed form up to 4x4, above every cofactor is the determinant of its minor
+template <typename T, size_t N>
+constexpr Matrix<T, N> adjugate(const Matrix<T, N> &matrix)
+{
+    const Matrix<T, N> &m = matrix;
+    Matrix<T, N> adj = {};
+    if constexpr (N == 1)
+    {
+        adj[0][0] = static_cast<T>(1);
+    }
+    else if constexpr (N == 2)
+    {
+        adj[0][0] = m[1][1];
+        adj[0][1] = -m[0][1];
+        adj[1][0] = -m[1][0];
+        adj[1][1] = m[0][0];
+    }
+    else if constexpr (N == 3)
+    {
+        adj[0][0] = m[1][1] * m[2][2] - m[1][2] * m[2][1];
+        adj[0][1] = m[0][2] * m[2][1] - m[0][1] * m[2][2];
+        adj[0][2] = m[0][1] * m[1][2] - m[0][2] * m[1][1];
+        adj[1][0] = m[1][2] * m[2][0] - m[1][0] * m[2][2];
+        adj[1][1] = m[0][0] * m[2][2] - m[0][2] * m[2][0];
+        adj[1][2] = m[0][2] * m[1][0] - m[0][0] * m[1][2];
+        adj[2][0] = m[1][0] * m[2][1] - m[1][1] * m[2][0];
+        adj[2][1] = m[0][1] * m[2][0] - m[0][0] * m[2][1];
+        adj[2][2] = m[0][0] * m[1][1] - m[0][1] * m[1][0];
+    }
+    else if constexpr (N == 4)
+    {
+        const T s0 = m[0][0] * m[1][1] - m[1][0] * m[0][1];
+        const T s1 = m[0][0] * m[1][2] - m[1][0] * m[0][2];
+        const T s2 = m[0][0] * m[1][3] - m[1][0] * m[0][3];
+        const T s3 = m[0][1] * m[1][2] - m[1][1] * m[0][2];
+        const T s4 = m[0][1] * m[1][3] - m[1][1] * m[0][3];
+        const T s5 = m[0][2] * m[1][3] - m[1][2] * m[0][3];
+        const T c0 = m[2][0] * m[3][1] - m[3][0] * m[2][1];
+        const T c1 = m[2][0] * m[3][2] - m[3][0] * m[2][2];
+        const T c2 = m[2][0] * m[3][3] - m[3][0] * m[2][3];
+        const T c3 = m[2][1] * m[3][2] - m[3][1] * m[2][2];
+        const T c4 = m[2][1] * m[3][3] - m[3][1] * m[2][3];
+        const T c5 = m[2][2] * m[3][3] - m[3][2] * m[2][3];
+
+        adj[0][0] = m[1][1] * c5 - m[1][2] * c4 + m[1][3] * c3;
+        adj[0][1] = -m[0][1] * c5 + m[0][2] * c4 - m[0][3] * c3;
+        adj[0][2] = m[3][1] * s5 - m[3][2] * s4 + m[3][3] * s3;
+        adj[0][3] = -m[2][1] * s5 + m[2][2] * s4 - m[2][3] * s3;
+        adj[1][0] = -m[1][0] * c5 + m[1][2] * c2 - m[1][3] * c1;
+        adj[1][1] = m[0][0] * c5 - m[0][2] * c2 + m[0][3] * c1;
+        adj[1][2] = -m[3][0] * s5 + m[3][2] * s2 - m[3][3] * s1;
+        adj[1][3] = m[2][0] * s5 - m[2][2] * s2 + m[2][3] * s1;
+        adj[2][0] = m[1][0] * c4 - m[1][1] * c2 + m[1][3] * c0;
+        adj[2][1] = -m[0][0] * c4 + m[0][1] * c2 - m[0][3] * c0;
+        adj[2][2] = m[3][0] * s4 - m[3][1] * s2 + m[3][3] * s0;
+        adj[2][3] = -m[2][0] * s4 + m[2][1] * s2 - m[2][3] * s0;
+        adj[3][0] = -m[1][0] * c3 + m[1][1] * c1 - m[1][2] * c0;
+        adj[3][1] = m[0][0] * c3 - m[0][1] * c1 + m[0][2] * c0;
+        adj[3][2] = -m[3][0] * s3 + m[3][1] * s1 - m[3][2] * s0;
+        adj[3][3] = m[2][0] * s3 - m[2][1] * s1 + m[2][2] * s0;
+    }
+    else
+    {
+        // singular matrices still have an adjugate, so it cannot be derived from the inverse
+        Matrix<T, N - 1> minor = {};
+        for (size_t row = 0; row < N; ++row)
+        {
+            for (size_t col = 0; col < N; ++col)
+            {
+                for (size_t minor_row = 0; minor_row < N - 1; ++minor_row)
+                {
+                    for (size_t minor_col = 0; minor_col < N - 1; ++minor_col)
+                    {
+                        minor[minor_row][minor_col] = m[minor_row < row ? minor_row : minor_row + 1][minor_col < col ? minor_col : minor_col + 1];
+                    }
+                }
+                const T sign = static_cast<T>((row + col) % 2 == 0 ? 1 : -1);
+                adj[col][row] = sign * determinant(minor);
+            }
+        }
+    }
+    return adj;
+}
+
+// Closed form up to 4x4, above the columns of the identity are solved against one LU decomposition. Like the cofactor
+// version, singular matrices give non-finite elements.
+template <typename T, size_t N>
+constexpr Matrix<T, N> inverse(const Matrix<T, N> &matrix)
+{
+    if constexpr (N <= 4)
+    {
+        Matrix<T, N> inv = adjugate(matrix);
+        inv /= determinant(matrix);
+        return inv;
+    }
+    else
+    {
+        Matrix<T, N> lu = matrix;
+        std::array<size_t, N> pivots = {};
+        if (lu_decompose(lu, pivots) == static_cast<T>(0))
+        {
+            Matrix<T, N> inv = {};
+            for (auto &row : inv)
+            {
+                for (auto &element : row)
+                {
+                    element = std::numeric_limits<T>::quiet_NaN();
+                }
+            }
+            return inv;
+        }
+
+        Matrix<T, N> inv = {};
+        for (size_t col = 0; col < N; ++col)
+        {
+            std::array<T, N> column = {};
+            column[col] = static_cast<T>(1);
+            lu_solve(lu, pivots, column);
+            for (size_t row = 0; row < N; ++row)
+            {
+                inv[row][col] = column[row];
+            }
+        }
+        return inv;
+    }
+}
+
+#if defined(MATRIX_SSE2)
+// SSE2 versions of the 4x4 float operations, picked by overload resolution over the templates. The rows are loaded
+// unaligned, std::array only guarantees the alignment of float. Call e.g. inverse<float, 4> to get the generic version,
+// which constant evaluation does as well.
+
+namespace matrix_sse2
+{
+    template <int X, int Y, int Z, int W>
+    __m128 swizzle(const __m128 v)
+    {
+        return _mm_shuffle_ps(v, v, _MM_SHUFFLE(W, Z, Y, X));
+    }
+
+    // products of 2x2 matrices stored row by row in one register, adj(a) is the adjugate of a
+    inline __m128 mat2_mul(const __m128 a, const __m128 b)
+    {
+        return _mm_add_ps(_mm_mul_ps(a, swizzle<0, 3, 0, 3>(b)), _mm_mul_ps(swizzle<1, 0, 3, 2>(a), swizzle<2, 1, 2, 1>(b)));
+    }
+
+    // adj(a) * b
+    inline __m128 mat2_adj_mul(const __m128 a, const __m128 b)
+    {
+        return _mm_sub_ps(_mm_mul_ps(swizzle<3, 3, 0, 0>(a), b), _mm_mul_ps(swizzle<1, 1, 2, 2>(a), swizzle<2, 3, 0, 1>(b)));
+    }
+
+    // a * adj(b)
+    inline __m128 mat2_mul_adj(const __m128 a, const __m128 b)
+    {
+        return _mm_sub_ps(_mm_mul_ps(a, swizzle<3, 0, 3, 0>(b)), _mm_mul_ps(swizzle<1, 0, 3, 2>(a), swizzle<2, 1, 2, 1>(b)));
+    }
+}
+
+constexpr void transpose(Matrix4<float> &matrix)
+{
+    if (__builtin_is_constant_evaluated())
+    {
+        transpose<float, 4>(matrix);
+        return;
+    }
+
+    // _MM_TRANSPOSE4_PS spelled out, MSVC's version declares uninitialized variables that constexpr functions forbid
+    const __m128 row0 = _mm_loadu_ps(matrix[0].data());
+    const __m128 row1 = _mm_loadu_ps(matrix[1].data());
+    const __m128 row2 = _mm_loadu_ps(matrix[2].data());
+    const __m128 row3 = _mm_loadu_ps(matrix[3].data());
+    const __m128 low01 = _mm_unpacklo_ps(row0, row1);
+    const __m128 low23 = _mm_unpacklo_ps(row2, row3);
+    const __m128 high01 = _mm_unpackhi_ps(row0, row1);
+    const __m128 high23 = _mm_unpackhi_ps(row2, row3);
+    _mm_storeu_ps(matrix[0].data(), _mm_movelh_ps(low01, low23));
+    _mm_storeu_ps(matrix[1].data(), _mm_movehl_ps(low23, low01));
+    _mm_storeu_ps(matrix[2].data(), _mm_movelh_ps(high01, high23));
+    _mm_storeu_ps(matrix[3].data(), _mm_movehl_ps(high23, high01));
+}
+
+constexpr Matrix4<float> operator*(const Matrix4<float> &lhs, const Matrix4<float> &rhs)
+{
+    if (__builtin_is_constant_evaluated())
+    {
+        return operator*<float, 4>(lhs, rhs);
+    }
+
+    const __m128 rhs0 = _mm_loadu_ps(rhs[0].data());
+    const __m128 rhs1 = _mm_loadu_ps(rhs[1].data());
+    const __m128 rhs2 = _mm_loadu_ps(rhs[2].data());
+    const __m128 rhs3 = _mm_loadu_ps(rhs[3].data());
+
+    Matrix4<float> product = {};
+    for (size_t row = 0; row < 4; ++row)
+    {
+        // every row of the product is a linear combination of the rows of rhs
+        const __m128 lhs_row = _mm_loadu_ps(lhs[row].data());
+        __m128 product_row = _mm_mul_ps(matrix_sse2::swizzle<0, 0, 0, 0>(lhs_row), rhs0);
+        product_row = _mm_add_ps(product_row, _mm_mul_ps(matrix_sse2::swizzle<1, 1, 1, 1>(lhs_row), rhs1));
+        product_row = _mm_add_ps(product_row, _mm_mul_ps(matrix_sse2::swizzle<2, 2, 2, 2>(lhs_row), rhs2));
+        product_row = _mm_add_ps(product_row, _mm_mul_ps(matrix_sse2::swizzle<3, 3, 3, 3>(lhs_row), rhs3));
+        _mm_storeu_ps(product[row].data(), product_row);
+    }
+    return product;
+}
+
+// Inverts the 2x2 blocks | A B | of matrix with the block formulas, which only need 2x2 adjugates:
+//                        | C D |
+// |M| = |A||D| + |B||C| - tr(adj(A)B adj(D)C), and M^-1 = 1 / |M| * | adj(X) adj(Y) | with X = |D|A - B adj(D)C,
+//                                                                   | adj(Z) adj(W) |
+// Y = |B|C - D adj(adj(A)B), Z = |C|B - A adj(adj(D)C) and W = |A|D - C adj(A)B.
+constexpr Matrix4<float> inverse(const Matrix4<float> &matrix)
+{
+    if (__builtin_is_constant_evaluated())
+    {
+        return inverse<float, 4>(matrix);
+    }
+
+    const __m128 row0 = _mm_loadu_ps(matrix[0].data());
+    const __m128 row1 = _mm_loadu_ps(matrix[1].data());
+    const __m128 row2 = _mm_loadu_ps(matrix[2].data());
+    const __m128 row3 = _mm_loadu_ps(matrix[3].data());
+
+    const __m128 a = _mm_movelh_ps(row0, row1);
+    const __m128 b = _mm_movehl_ps(row1, row0);
+    const __m128 c = _mm_movelh_ps(row2, row3);
+    const __m128 d = _mm_movehl_ps(row3, row2);
+
+    // |A|, |B|, |C| and |D|
+    const __m128 block_dets = _mm_sub_ps(
+        _mm_mul_ps(_mm_shuffle_ps(row0, row2, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(row1, row3, _MM_SHUFFLE(3, 1, 3, 1))),
+        _mm_mul_ps(_mm_shuffle_ps(row0, row2, _MM_SHUFFLE(3, 1, 3, 1)), _mm_shuffle_ps(row1, row3, _MM_SHUFFLE(2, 0, 2, 0))));
+    const __m128 det_a = matrix_sse2::swizzle<0, 0, 0, 0>(block_dets);
+    const __m128 det_b = matrix_sse2::swizzle<1, 1, 1, 1>(block_dets);
+    const __m128 det_c = matrix_sse2::swizzle<2, 2, 2, 2>(block_dets);
+    const __m128 det_d = matrix_sse2::swizzle<3, 3, 3, 3>(block_dets);
+
+    const __m128 adj_a_b = matrix_sse2::mat2_adj_mul(a, b);
+    const __m128 adj_d_c = matrix_sse2::mat2_adj_mul(d, c);
+    __m128 x = _mm_sub_ps(_mm_mul_ps(det_d, a), matrix_sse2::mat2_mul(b, adj_d_c));
+    __m128 y = _mm_sub_ps(_mm_mul_ps(det_b, c), matrix_sse2::mat2_mul_adj(d, adj_a_b));
+    __m128 z = _mm_sub_ps(_mm_mul_ps(det_c, b), matrix_sse2::mat2_mul_adj(a, adj_d_c));
+    __m128 w = _mm_sub_ps(_mm_mul_ps(det_a, d), matrix_sse2::mat2_mul(c, adj_a_b));
+
+    // the trace of the product as dot product, summed across all lanes
+    __m128 trace = _mm_mul_ps(adj_a_b, matrix_sse2::swizzle<0, 2, 1, 3>(adj_d_c));
+    trace = _mm_add_ps(trace, matrix_sse2::swizzle<2, 3, 0, 1>(trace));
+    trace = _mm_add_ps(trace, matrix_sse2::swizzle<1, 0, 3, 2>(trace));
+    const __m128 det = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(det_a, det_d), _mm_mul_ps(det_b, det_c)), trace);
+
+    // the signs of the 2x2 adjugates, the swaps happen in the shuffles below
+    const __m128 scale = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), det);
+    x = _mm_mul_ps(x, scale);
+    y = _mm_mul_ps(y, scale);
+    z = _mm_mul_ps(z, scale);
+    w = _mm_mul_ps(w, scale);
+
+    Matrix4<float> inv = {};
+    _mm_storeu_ps(inv[0].data(), _mm_shuffle_ps(x, y, _MM_SHUFFLE(1, 3, 1, 3)));
+    _mm_storeu_ps(inv[1].data(), _mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 2, 0, 2)));
+    _mm_storeu_ps(inv[2].data(), _mm_shuffle_ps(z, w, _MM_SHUFFLE(1, 3, 1, 3)));
+    _mm_storeu_ps(inv[3].data(), _mm_shuffle_ps(z, w, _MM_SHUFFLE(0, 2, 0, 2)));
+    return inv;
+}
+#endif
\ No newline at end of file
@@ -5,6 +5,18 @@
 #include "DebugUtil.h"
 #include "GeometryUtil.h"
 
+namespace
+{
+    constexpr GeometryUtil::VertexAttributeDesc attributeDescs[] = {
+        {GeometryUtil::VertexAttributeType::POSITION, 0u},
+        {GeometryUtil::VertexAttributeType::UNINITIALIZED, 12u},
+    };
+
+    constexpr GeometryUtil::VertexDesc vertexDesc = {
+        sizeof(attributeDescs) / sizeof(GeometryUtil::VertexAttributeDesc), attributeDescs, 24u,
+    };
+}
+
 LandAndWavesDemo::~LandAndWavesDemo()
 {
     UINT64 maxFenceWaitValue = 0u;
@@ -65,16 +77,6 @@ void LandAndWavesDemo::initialize()
 
     ThrowIfFailed(m_pDevice->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_pFrameFence)));
 
-
-    static constexpr GeometryUtil::VertexAttributeDesc attributeDescs[] = {
-        {GeometryUtil::VertexAttributeType::POSITION, 0u},
-        {GeometryUtil::VertexAttributeType::UNINITIALIZED, 12u},
-    };
-
-    static constexpr GeometryUtil::VertexDesc vertexDesc = {
-        sizeof(attributeDescs) / sizeof(GeometryUtil::VertexAttributeDesc), attributeDescs, 24u,
-    };
-
     constexpr float width = 25.0f;
     size_t landVertexCount;
     {
@@ -83,7 +85,7 @@ void LandAndWavesDemo::initialize()
 
         std::unique_ptr<Vertex[]> p_landVertices = std::make_unique<Vertex[]>(landVertexCount);
         std::unique_ptr<uint16_t[]> p_landIndices = std::make_unique<uint16_t[]>(landIndexCount);
-        GeometryUtil::createSquare(width, VERTICES_PER_SIDE, p_landVertices.get(), p_landIndices.get(), vertexDesc);
+        GeometryUtil::createSquare<vertexDesc>(width, VERTICES_PER_SIDE, p_landVertices.get(), p_landIndices.get());
 
         for (uint16_t y = 0; y < VERTICES_PER_SIDE; ++y)
         {
@@ -116,7 +118,7 @@ void LandAndWavesDemo::initialize()
             }
         }
 
-        m_landMesh.createVertexBuffer(p_landVertices.get(), landVertexCount, sizeof(Vertex), m_pCommandList.Get());
+        m_landMesh.createVertexBuffer(p_landVertices.get(), landVertexCount, vertexDesc, m_pCommandList.Get());
         m_landMesh.createIndexBuffer(p_landIndices.get(), landIndexCount, sizeof(uint16_t), m_pCommandList.Get());
     }
 
@@ -124,7 +126,7 @@ void LandAndWavesDemo::initialize()
         GeometryUtil::calculateVertexIndexCountsSquare(VERTICES_PER_SIDE, m_wavesVertexCount, m_wavesIndexCount);
 
         std::unique_ptr<uint16_t[]> pIndices = std::make_unique<uint16_t[]>(m_wavesIndexCount);
-        GeometryUtil::createSquare(width, VERTICES_PER_SIDE, m_wavesVertices, pIndices.get(), vertexDesc);
+        GeometryUtil::createSquare<vertexDesc>(width, VERTICES_PER_SIDE, m_wavesVertices, pIndices.get());
 
         D3D12Util::createAndUploadBuffer(pIndices.get(), m_wavesIndexCount * sizeof(uint16_t), m_pCommandList.Get(), &m_pWavesIndexBuffer, &m_pWavesIndexBufferUpload);
     }
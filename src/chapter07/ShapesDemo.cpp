@@ -4,6 +4,19 @@
 #include "GeometryUtil.h"
 #include "Renderable.h"
 
+namespace
+{
+    constexpr GeometryUtil::VertexAttributeDesc attributeCollection[] =
+    {
+        {GeometryUtil::VertexAttributeType::POSITION, 0u},
+        {GeometryUtil::VertexAttributeType::NORMAL, 12u},
+    };
+
+    constexpr GeometryUtil::VertexDesc vertexDesc = {
+        sizeof(attributeCollection) / sizeof(GeometryUtil::VertexAttributeDesc), attributeCollection, 24u
+    };
+}
+
 ShapesDemo::~ShapesDemo()
 {
     for (const FrameResources& frameResources : m_frameResources)
@@ -24,17 +37,6 @@ void ShapesDemo::initialize()
     m_pCommandList->Reset(m_pCommandAllocator.Get(), nullptr);
 
     {
-
-        static constexpr GeometryUtil::VertexAttributeDesc attributeCollection[] =
-        {
-            {GeometryUtil::VertexAttributeType::POSITION, 0u},
-            {GeometryUtil::VertexAttributeType::NORMAL, 12u},
-        };
-
-        static constexpr GeometryUtil::VertexDesc vertexDesc = {
-            sizeof(attributeCollection) / sizeof(GeometryUtil::VertexAttributeDesc), attributeCollection, 24u
-        };
-
         m_pMesh = std::make_unique<Mesh>();
         {
             struct Vertex {
@@ -111,7 +113,7 @@ void ShapesDemo::initialize()
                 size_t startIndex = indices.size();
                 vertices.resize(vertices.size() + vertexCountSquare);
                 indices.resize(indices.size() + indexCountSquare);
-                GeometryUtil::createSquare(10.0f, 15, vertices.data() + startVertex, indices.data() + startIndex, vertexDesc);
+                GeometryUtil::createSquare<vertexDesc>(10.0f, 15, vertices.data() + startVertex, indices.data() + startIndex);
 
                 {
                     Renderable renderable;
@@ -153,24 +155,27 @@ void ShapesDemo::initialize()
                 m_renderables.emplace_back(renderable);
             }
 
-            for (uint8_t i = 0; i < objectCount - 2u; ++i)
+            // the geospheres are the levels of one LOD chain and share its vertices
             {
+                constexpr uint8_t maxSubdivisions = objectCount - 3u;
                 size_t vertexCountGeoSphere;
                 size_t indexCountGeoSphere;
-                GeometryUtil::calculateVertexIndexCountsGeoSphere(i, vertexCountGeoSphere, indexCountGeoSphere);
+                GeometryUtil::calculateVertexIndexCountsGeoSphereLodChain(maxSubdivisions, vertexCountGeoSphere, indexCountGeoSphere);
 
                 size_t startVertex = vertices.size();
                 size_t startIndex = indices.size();
                 vertices.resize(vertices.size() + vertexCountGeoSphere);
                 indices.resize(indices.size() + indexCountGeoSphere);
-                GeometryUtil::createGeoSphere(1.0f, i, vertices.data() + startVertex, indices.data() + startIndex, vertexDesc);
+                GeometryUtil::GeoSphereLod lods[maxSubdivisions + 1u];
+                GeometryUtil::createGeoSphereLodChain<vertexDesc>(1.0f, maxSubdivisions, vertices.data() + startVertex, indices.data() + startIndex, lods);
 
+                for (uint8_t i = 0; i <= maxSubdivisions; ++i)
                 {
                     Renderable renderable;
                     renderable.m_cbIndex = 3u + i;
-                    renderable.m_startIndex = static_cast<UINT>(startIndex);
+                    renderable.m_startIndex = static_cast<UINT>(startIndex + lods[i].startIndex);
                     renderable.m_baseVertex = static_cast<UINT>(startVertex);
-                    renderable.m_indexCount = static_cast<UINT>(indexCountGeoSphere);
+                    renderable.m_indexCount = static_cast<UINT>(lods[i].indexCount);
                     DirectX::XMMATRIX model = DirectX::XMMatrixRotationY(renderable.m_cbIndex * DirectX::g_XMTwoPi[0] / objectCount);
                     model = DirectX::XMMatrixMultiply(DirectX::XMMatrixTranslation(0.0f, 1.0f, distanceFromCenter), model);
                     DirectX::XMStoreFloat4x4(&renderable.m_model, model);
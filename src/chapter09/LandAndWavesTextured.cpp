@@ -72,7 +72,7 @@ void LandAndWavesTextured::initialize()
 
         std::unique_ptr<Vertex[]> p_landVertices = std::make_unique<Vertex[]>(landVertexCount);
         std::unique_ptr<uint16_t[]> p_landIndices = std::make_unique<uint16_t[]>(landIndexCount);
-        GeometryUtil::createSquare(m_gridWidth, VERTICES_PER_SIDE, p_landVertices.get(), p_landIndices.get());
+        GeometryUtil::createSquare<GeometryUtil::defaultVertexDesc>(m_gridWidth, VERTICES_PER_SIDE, p_landVertices.get(), p_landIndices.get());
 
         for (uint16_t y = 0; y < VERTICES_PER_SIDE; ++y)
         {
@@ -97,7 +97,7 @@ void LandAndWavesTextured::initialize()
         // not thread safe
         size_t meshIndex = m_meshes.size();
         Mesh landMesh;
-        landMesh.createVertexBuffer(p_landVertices.get(), landVertexCount, sizeof(Vertex), m_pCommandList.Get());
+        landMesh.createVertexBuffer(p_landVertices.get(), landVertexCount, GeometryUtil::defaultVertexDesc, m_pCommandList.Get());
         landMesh.createIndexBuffer(p_landIndices.get(), landIndexCount, sizeof(uint16_t), m_pCommandList.Get());
         m_meshes.emplace_back(landMesh);
 
@@ -133,7 +133,7 @@ void LandAndWavesTextured::initialize()
         GeometryUtil::calculateVertexIndexCountsSquare(VERTICES_PER_SIDE, wavesVertexCount, wavesIndexCount);
 
         std::unique_ptr<uint16_t[]> pIndices = std::make_unique<uint16_t[]>(wavesIndexCount);
-        GeometryUtil::createSquare(m_gridWidth, VERTICES_PER_SIDE, m_wavesVertices, pIndices.get());
+        GeometryUtil::createSquare<GeometryUtil::defaultVertexDesc>(m_gridWidth, VERTICES_PER_SIDE, m_wavesVertices, pIndices.get());
 
         // not thread safe
         size_t meshIndex = m_meshes.size();
@@ -3,7 +3,10 @@
 #include <iostream>
 
 #include "DebugUtil.h"
+#include "GeometryCacheUtil.h"
 #include "GeometryUtil.h"
+#include "MeshOptimizationUtil.h"
+#include "MeshSimplificationUtil.h"
 
 LandAndWavesBlended::~LandAndWavesBlended()
 {
@@ -61,6 +64,9 @@ void LandAndWavesBlended::onMouseMove(int16_t xPos, int16_t yPos, uint8_t button
 
 void LandAndWavesBlended::initialize()
 {
+    // the waves only need to move smoothly, not to be recomputed for every frame
+    setFixedTimestep(m_simulationStep);
+
     ThrowIfFailed(m_pCommandList->Reset(m_pCommandAllocator.Get(), nullptr));
 
     ThrowIfFailed(m_pDevice->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_pFrameFence)));
@@ -70,35 +76,71 @@ void LandAndWavesBlended::initialize()
         size_t landIndexCount;
         GeometryUtil::calculateVertexIndexCountsSquare(VERTICES_PER_SIDE, landVertexCount, landIndexCount);
 
-        std::unique_ptr<Vertex[]> pLandVertices = std::make_unique<Vertex[]>(landVertexCount);
-        std::unique_ptr<uint16_t[]> pLandIndices = std::make_unique<uint16_t[]>(landIndexCount);
-        GeometryUtil::createSquare(m_gridWidth, VERTICES_PER_SIDE, pLandVertices.get(), pLandIndices.get());
-
-        for (uint16_t y = 0; y < VERTICES_PER_SIDE; ++y)
+        // displacing, simplifying and optimizing the land takes far longer than mapping the result of an earlier launch,
+        // bump landCacheVersion whenever the generation below changes
+        constexpr uint32_t landCacheVersion = 1u;
+        uint64_t landCacheKey = GeometryCacheUtil::hashString("LandAndWavesBlended land");
+        landCacheKey = GeometryCacheUtil::hashValue(landCacheVersion, landCacheKey);
+        landCacheKey = GeometryCacheUtil::hashValue(VERTICES_PER_SIDE, landCacheKey);
+        landCacheKey = GeometryCacheUtil::hashValue(m_gridWidth, landCacheKey);
+        landCacheKey = GeometryCacheUtil::hashValue(sizeof(GridIndex), landCacheKey);
+        landCacheKey = GeometryCacheUtil::hashVertexDesc(GeometryUtil::defaultVertexDesc, landCacheKey);
+
+        GeometryCacheUtil::MappedMesh cachedLand;
+        GeometryCacheUtil::MeshView land;
+        std::unique_ptr<GridIndex[]> pOptimizedLandIndices;
+        std::unique_ptr<Vertex[]> pOptimizedLandVertices;
+        if (cachedLand.map(L"cache", landCacheKey))
         {
-            for (uint16_t x = 0; x < VERTICES_PER_SIDE; ++x)
-            {
-                Vertex& vertex = pLandVertices[y * VERTICES_PER_SIDE + x];
-                float sinX = DirectX::XMScalarSinEst(vertex.pos.x * 16.0f / (m_gridWidth));
-                float cosZ = DirectX::XMScalarCosEst(vertex.pos.z * 16.0f / (m_gridWidth));
-                vertex.pos.y = (6.0f*(vertex.pos.z* sinX + vertex.pos.x*cosZ) + 0.5f) / m_gridWidth;
+            land = cachedLand.getView();
+        }
+        else
+        {
+            std::unique_ptr<Vertex[]> pLandVertices = std::make_unique<Vertex[]>(landVertexCount);
+            std::unique_ptr<GridIndex[]> pLandIndices = std::make_unique<GridIndex[]>(landIndexCount);
+            GeometryUtil::createSquare<GeometryUtil::defaultVertexDesc>(m_gridWidth, VERTICES_PER_SIDE, pLandVertices.get(), pLandIndices.get());
 
-                float sinXdx = (16.0f / (m_gridWidth)) * DirectX::XMScalarCosEst(vertex.pos.x * 16.0f / (m_gridWidth));
-                float cosZdz = -(16.0f / (m_gridWidth)) * DirectX::XMScalarSinEst(vertex.pos.z * 16.0f / (m_gridWidth));
-                DirectX::XMVECTOR normal = {
-                    -(6.0f * vertex.pos.z * sinXdx + cosZ) / m_gridWidth,
-                    1.0f,
-                    -(6.0f * vertex.pos.x * cosZdz + sinX) / m_gridWidth,
-                };
-                DirectX::XMStoreFloat3(&vertex.normal, DirectX::XMVector3Normalize(normal));
+            for (uint32_t y = 0; y < VERTICES_PER_SIDE; ++y)
+            {
+                for (uint32_t x = 0; x < VERTICES_PER_SIDE; ++x)
+                {
+                    Vertex& vertex = pLandVertices[y * VERTICES_PER_SIDE + x];
+                    float sinX = DirectX::XMScalarSinEst(vertex.pos.x * 16.0f / (m_gridWidth));
+                    float cosZ = DirectX::XMScalarCosEst(vertex.pos.z * 16.0f / (m_gridWidth));
+                    vertex.pos.y = (6.0f*(vertex.pos.z* sinX + vertex.pos.x*cosZ) + 0.5f) / m_gridWidth;
+
+                    float sinXdx = (16.0f / (m_gridWidth)) * DirectX::XMScalarCosEst(vertex.pos.x * 16.0f / (m_gridWidth));
+                    float cosZdz = -(16.0f / (m_gridWidth)) * DirectX::XMScalarSinEst(vertex.pos.z * 16.0f / (m_gridWidth));
+                    DirectX::XMVECTOR normal = {
+                        -(6.0f * vertex.pos.z * sinXdx + cosZ) / m_gridWidth,
+                        1.0f,
+                        -(6.0f * vertex.pos.x * cosZdz + sinX) / m_gridWidth,
+                    };
+                    DirectX::XMStoreFloat3(&vertex.normal, DirectX::XMVector3Normalize(normal));
+                }
             }
+
+            // flat parts of the terrain need far fewer triangles, the border is locked to keep the square outline
+            landIndexCount = MeshSimplificationUtil::simplifyMesh(pLandIndices.get(), pLandIndices.get(), landIndexCount, pLandVertices.get(), landVertexCount,
+                GeometryUtil::defaultVertexDesc, 0u, 0.001f, true);
+
+            // the land mesh is static, so its triangles and vertices can be reordered for the post-transform cache and
+            // vertex fetch, which also drops the vertices simplification left unused
+            pOptimizedLandIndices = std::make_unique<GridIndex[]>(landIndexCount);
+            MeshOptimizationUtil::optimizeVertexCache(pOptimizedLandIndices.get(), pLandIndices.get(), landIndexCount, landVertexCount);
+            pOptimizedLandVertices = std::make_unique<Vertex[]>(landVertexCount);
+            const size_t optimizedLandVertexCount = MeshOptimizationUtil::optimizeVertexFetch(pOptimizedLandVertices.get(), pOptimizedLandIndices.get(), landIndexCount,
+                pLandVertices.get(), landVertexCount, sizeof(Vertex));
+
+            land = { pOptimizedLandVertices.get(), optimizedLandVertexCount, sizeof(Vertex), pOptimizedLandIndices.get(), landIndexCount, sizeof(GridIndex) };
+            GeometryCacheUtil::storeMesh(L"cache", landCacheKey, land);
         }
 
         // not thread safe
         size_t meshIndex = m_meshes.size();
         Mesh landMesh;
-        landMesh.createVertexBuffer(pLandVertices.get(), landVertexCount, sizeof(Vertex), m_pCommandList.Get());
-        landMesh.createIndexBuffer(pLandIndices.get(), landIndexCount, sizeof(uint16_t), m_pCommandList.Get());
+        landMesh.createVertexBuffer(land.pVertices, land.vertexCount, GeometryUtil::defaultVertexDesc, m_pCommandList.Get());
+        landMesh.createIndexBuffer(land.pIndices, land.indexCount, land.indexSize, m_pCommandList.Get());
         m_meshes.emplace_back(landMesh);
 
         // not thread safe
@@ -123,7 +165,7 @@ void LandAndWavesBlended::initialize()
         landRenderable.m_cbIndex = 0;
         landRenderable.m_startIndex = 0;
         landRenderable.m_baseVertex = 0;
-        landRenderable.m_indexCount = static_cast<UINT>(landIndexCount);
+        landRenderable.m_indexCount = static_cast<UINT>(land.indexCount);
         m_opaqueRenderables.emplace_back(landRenderable);
     }
 
@@ -132,14 +174,18 @@ void LandAndWavesBlended::initialize()
         size_t wavesIndexCount;
         GeometryUtil::calculateVertexIndexCountsSquare(VERTICES_PER_SIDE, wavesVertexCount, wavesIndexCount);
 
-        std::unique_ptr<uint16_t[]> pIndices = std::make_unique<uint16_t[]>(wavesIndexCount);
-        GeometryUtil::createSquare(m_gridWidth, VERTICES_PER_SIDE, m_wavesVertices, pIndices.get());
+        std::unique_ptr<GridIndex[]> pGridIndices = std::make_unique<GridIndex[]>(wavesIndexCount);
+        GeometryUtil::createSquare<GeometryUtil::defaultVertexDesc>(m_gridWidth, VERTICES_PER_SIDE, m_wavesVertices, pGridIndices.get());
+
+        // wave vertices are updated in grid order every frame, so only the triangles are reordered
+        std::unique_ptr<GridIndex[]> pIndices = std::make_unique<GridIndex[]>(wavesIndexCount);
+        MeshOptimizationUtil::optimizeVertexCache(pIndices.get(), pGridIndices.get(), wavesIndexCount, wavesVertexCount);
 
         // not thread safe
         size_t meshIndex = m_meshes.size();
         Mesh wavesMesh;
         wavesMesh.m_indexCount = wavesIndexCount;
-        wavesMesh.m_indexSize = sizeof(uint16_t);
+        wavesMesh.m_indexSize = sizeof(GridIndex);
         wavesMesh.m_vertexCount = wavesVertexCount;
         wavesMesh.m_vertexSize[0] = sizeof(Vertex);
 
@@ -181,15 +227,14 @@ void LandAndWavesBlended::initialize()
         const uint8_t sphereSubdivisions = 3u;
         GeometryUtil::calculateVertexIndexCountsGeoSphere(sphereSubdivisions, sphereVertexCount, sphereIndexCount);
 
-        std::unique_ptr<uint16_t[]> pIndices = std::make_unique<uint16_t[]>(sphereIndexCount);
-        std::unique_ptr<Vertex[]> pVertices = std::make_unique<Vertex[]>(sphereVertexCount);
-        GeometryUtil::createGeoSphere(2.0f, sphereSubdivisions, pVertices.get(), pIndices.get());
-
         // not thread safe
         size_t meshIndex = m_meshes.size();
         Mesh sphereMesh;
-        sphereMesh.createVertexBuffer(pVertices.get(), sphereVertexCount, sizeof(Vertex), m_pCommandList.Get());
-        sphereMesh.createIndexBuffer(pIndices.get(), sphereIndexCount, sizeof(uint16_t), m_pCommandList.Get());
+
+        // generated straight into the upload buffers, without temporary arrays and the copy out of them
+        void* const pVertices = sphereMesh.createVertexBufferForWriting(sphereVertexCount, sizeof(Vertex), m_pCommandList.Get());
+        uint16_t* const pIndices = static_cast<uint16_t*>(sphereMesh.createIndexBufferForWriting(sphereIndexCount, sizeof(uint16_t), m_pCommandList.Get()));
+        sphereMesh.m_bounds = GeometryUtil::createGeoSphere(2.0f, sphereSubdivisions, pVertices, pIndices, GeometryUtil::StaticWriteCombinedVertexWriter<GeometryUtil::defaultVertexDesc>());
         m_meshes.emplace_back(sphereMesh);
 
         // not thread safe
@@ -467,25 +512,15 @@ void LandAndWavesBlended::initialize()
     ThrowIfFailed(m_pCommandAllocator->Reset());
 };
 
-void LandAndWavesBlended::update(float dt)
+void LandAndWavesBlended::fixedUpdate(float step)
 {
-    m_camera.update();
-    m_curFrameResourcesIndex = (m_curFrameResourcesIndex + 1u) % FRAME_RESOURCES_COUNT;
-    const FrameResources& curFrameResources = m_frameResources[m_curFrameResourcesIndex];
-
-    if (m_pFrameFence->GetCompletedValue() < curFrameResources.m_fenceValue)
-    {
-        HANDLE hEvent = CreateEventEx(nullptr, nullptr, 0, EVENT_ALL_ACCESS);
-        ThrowIfFailed(m_pFrameFence->SetEventOnCompletion(curFrameResources.m_fenceValue, hEvent));
-        WaitForSingleObject(hEvent, INFINITE);
-        CloseHandle(hEvent);
-    }
+    m_wavesTime += step;
 
     {
         constexpr float scale = 0.005f;
-        for (uint16_t y = 0; y < VERTICES_PER_SIDE; ++y)
+        for (uint32_t y = 0; y < VERTICES_PER_SIDE; ++y)
         {
-            for (uint16_t x = 0; x < VERTICES_PER_SIDE; ++x)
+            for (uint32_t x = 0; x < VERTICES_PER_SIDE; ++x)
             {
                 float offset = 0.0f;
                 float iterationScale = 1.0f;
@@ -497,7 +532,7 @@ void LandAndWavesBlended::update(float dt)
                 {
                     const float iterationX = iterationCoordScaleX * (x + iterationCoordOffsetX);
                     const float iterationY = iterationCoordScaleY * (y + iterationCoordOffsetY);
-                    offset += iterationScale * DirectX::XMScalarSinEst(m_timer.getElapsedTime() + iterationX + iterationY);
+                    offset += iterationScale * DirectX::XMScalarSinEst(m_wavesTime + iterationX + iterationY);
                     iterationScale *= 0.65f;
                     iterationCoordOffsetX += 0.23f;
                     iterationCoordOffsetX = std::fmodf(iterationCoordScaleX, 1.0f);
@@ -509,16 +544,16 @@ void LandAndWavesBlended::update(float dt)
                 }
                 m_wavesVertices[y][x].pos.y = scale * offset;
 
-                const uint16_t xPos = x < VERTICES_PER_SIDE - 1 ? x + 1 : x;
-                const uint16_t xNeg = x > 0 ? x - 1 : x;
+                const uint32_t xPos = x < VERTICES_PER_SIDE - 1 ? x + 1 : x;
+                const uint32_t xNeg = x > 0 ? x - 1 : x;
                 float xStep = m_gridWidth / VERTICES_PER_SIDE;
                 if (x <= 0 || x >= VERTICES_PER_SIDE - 1)
                 {
                     xStep *= 0.5f;
                 }
 
-                const uint16_t yPos = y < VERTICES_PER_SIDE - 1 ? y + 1 : y;
-                const uint16_t yNeg = y > 0 ? y - 1 : y;
+                const uint32_t yPos = y < VERTICES_PER_SIDE - 1 ? y + 1 : y;
+                const uint32_t yNeg = y > 0 ? y - 1 : y;
                 float yStep = m_gridWidth / VERTICES_PER_SIDE;
                 if (y <= 0 || y >= VERTICES_PER_SIDE - 1)
                 {
@@ -533,20 +568,59 @@ void LandAndWavesBlended::update(float dt)
                 DirectX::XMStoreFloat3(&m_wavesVertices[y][x].normal, DirectX::XMVector3Normalize(normal));
             }
         }
+    }
+
+    const auto& waveRenderable = m_transparentRenderables[m_waveRenderableIndex];
+    auto& waveMesh = m_meshes[waveRenderable.m_meshIndex];
+    waveMesh.m_bounds = GeometryUtil::calculateBounds(m_wavesVertices, GeometryUtil::defaultVertexDesc, waveMesh.m_vertexCount);
+    m_wavesFramesDirtyCount = FRAME_RESOURCES_COUNT;
+
+    m_previousWaveTexCoordOffset = m_waveTexCoordOffset;
+    m_waveTexCoordOffset.x += step * 0.02f;
+    if (m_waveTexCoordOffset.x >= 1.0f) {
+        m_waveTexCoordOffset.x -= 1.0f;
+    }
+    m_waveTexCoordOffset.y += step * 0.05f;
+    if (m_waveTexCoordOffset.y >= 1.0f) {
+        m_waveTexCoordOffset.y -= 1.0f;
+    }
+};
+
+void LandAndWavesBlended::update(float dt)
+{
+    m_camera.update();
+    m_curFrameResourcesIndex = (m_curFrameResourcesIndex + 1u) % FRAME_RESOURCES_COUNT;
+    const FrameResources& curFrameResources = m_frameResources[m_curFrameResourcesIndex];
+
+    if (m_pFrameFence->GetCompletedValue() < curFrameResources.m_fenceValue)
+    {
+        HANDLE hEvent = CreateEventEx(nullptr, nullptr, 0, EVENT_ALL_ACCESS);
+        ThrowIfFailed(m_pFrameFence->SetEventOnCompletion(curFrameResources.m_fenceValue, hEvent));
+        WaitForSingleObject(hEvent, INFINITE);
+        CloseHandle(hEvent);
+    }
 
+    {
+        // the latest waves of fixedUpdate still have to reach the vertex buffers of the other frame resources
         const auto& waveRenderable = m_transparentRenderables[m_waveRenderableIndex];
         auto& waveMesh = m_meshes[waveRenderable.m_meshIndex];
-        curFrameResources.m_pDynamicVertices->copyData(m_wavesVertices, waveMesh.m_vertexCount * waveMesh.m_vertexSize[0]);
+        if (m_wavesFramesDirtyCount > 0)
+        {
+            curFrameResources.m_pDynamicVertices->copyData(m_wavesVertices, waveMesh.m_vertexCount * waveMesh.m_vertexSize[0]);
+            --m_wavesFramesDirtyCount;
+        }
         waveMesh.m_pVertexBuffer[0] = curFrameResources.m_pDynamicVertices->getResourceComPtr();
+
+        // blends the last two simulated offsets, the current one may have wrapped around
+        const float alpha = getInterpolationAlpha();
+        auto interpolateOffset = [alpha](const float previous, const float current)
+        {
+            const float offset = previous + alpha * (current >= previous ? current - previous : current + 1.0f - previous);
+            return offset >= 1.0f ? offset - 1.0f : offset;
+        };
         auto& waveMaterial = m_materials[waveRenderable.m_materialIndex];
-        waveMaterial.texCoordOffset.x += dt * 0.02f;
-        if (waveMaterial.texCoordOffset.x >= 1.0f) {
-            waveMaterial.texCoordOffset.x -= 1.0f;
-        }
-        waveMaterial.texCoordOffset.y += dt * 0.05f;
-        if (waveMaterial.texCoordOffset.y >= 1.0f) {
-            waveMaterial.texCoordOffset.y -= 1.0f;
-        }
+        waveMaterial.texCoordOffset.x = interpolateOffset(m_previousWaveTexCoordOffset.x, m_waveTexCoordOffset.x);
+        waveMaterial.texCoordOffset.y = interpolateOffset(m_previousWaveTexCoordOffset.y, m_waveTexCoordOffset.y);
         waveMaterial.m_framesDirtyCount = FRAME_RESOURCES_COUNT;
     }
 
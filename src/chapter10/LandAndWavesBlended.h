@@ -27,6 +27,7 @@ public:
 
     virtual void initialize() override;
     virtual void update(float dt) override;
+    virtual void fixedUpdate(float step) override;
     virtual void render() override;
 
 private:
@@ -106,7 +107,8 @@ private:
     static constexpr float m_clearColor[4] = { 0.4f, 0.45f, 0.4f, 1.0f };
     static constexpr bool m_useFog = true;
     static constexpr size_t FRAME_RESOURCES_COUNT = 3u;
-    static constexpr uint16_t VERTICES_PER_SIDE = 100u;
+    static constexpr uint32_t VERTICES_PER_SIDE = 100u;
+    using GridIndex = Mesh::IndexTypeFor<VERTICES_PER_SIDE * VERTICES_PER_SIDE>;
     size_t m_curFrameResourcesIndex = 0u;
     FrameResources m_frameResources[FRAME_RESOURCES_COUNT];
     std::vector<Renderable> m_opaqueRenderables;
@@ -116,8 +118,14 @@ private:
     std::vector<Mesh> m_meshes;
     std::vector<DdsTexture> m_textures;
 
+    static constexpr float m_simulationStep = 1.0f / 60.0f;
     size_t m_waveRenderableIndex;
     Vertex m_wavesVertices[VERTICES_PER_SIDE][VERTICES_PER_SIDE];
+    // frame resources whose vertex buffer misses the latest waves
+    size_t m_wavesFramesDirtyCount = 0u;
+    float m_wavesTime = 0.0f;
+    DirectX::XMFLOAT2 m_previousWaveTexCoordOffset = { 0.0f, 0.0f };
+    DirectX::XMFLOAT2 m_waveTexCoordOffset = { 0.0f, 0.0f };
 
     Microsoft::WRL::ComPtr<ID3D12PipelineState> m_pPipelineStateOpaque;
     Microsoft::WRL::ComPtr<ID3D12PipelineState> m_pPipelineStateAlphaBlend;
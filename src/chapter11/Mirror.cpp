@@ -72,20 +72,23 @@ void Mirror::initialize()
     UINT currentRenderableCbIndex = 0u;
     UINT currentMaterialCbIndex = 0u;
 
+    // the wall quad and the sphere are generated at compile time and uploaded straight from read only data
+    static constexpr auto makeVertex = [](const GeometryUtil::VertexData& vertexData)
     {
-        size_t wallVertexCount;
-        size_t wallIndexCount;
-        GeometryUtil::calculateVertexIndexCountsSquare(VERTICES_PER_SIDE, wallVertexCount, wallIndexCount);
+        return Vertex{ vertexData.position, vertexData.uv, vertexData.normal };
+    };
 
-        std::unique_ptr<Vertex[]> pWallVertices = std::make_unique<Vertex[]>(wallVertexCount);
-        std::unique_ptr<uint16_t[]> pWallIndices = std::make_unique<uint16_t[]>(wallIndexCount);
-        GeometryUtil::createSquare(m_gridWidth, VERTICES_PER_SIDE, pWallVertices.get(), pWallIndices.get());
+    {
+        static constexpr auto wall = GeometryUtil::createStaticSquare<VERTICES_PER_SIDE, uint16_t>(m_gridWidth, makeVertex);
+        const size_t wallVertexCount = wall.vertices.size();
+        const size_t wallIndexCount = wall.indices.size();
 
         // not thread safe
         size_t meshIndex = m_meshes.size();
         Mesh squareMesh;
-        squareMesh.createVertexBuffer(pWallVertices.get(), wallVertexCount, sizeof(Vertex), m_pCommandList.Get());
-        squareMesh.createIndexBuffer(pWallIndices.get(), wallIndexCount, sizeof(uint16_t), m_pCommandList.Get());
+        squareMesh.createVertexBuffer(wall.vertices.data(), wallVertexCount, sizeof(Vertex), m_pCommandList.Get());
+        squareMesh.createIndexBuffer(wall.indices.data(), wallIndexCount, sizeof(uint16_t), m_pCommandList.Get());
+        squareMesh.m_bounds = wall.bounds;
         m_meshes.emplace_back(squareMesh);
 
         {
@@ -195,20 +198,16 @@ void Mirror::initialize()
     }
 
     {
-        size_t sphereVertexCount;
-        size_t sphereIndexCount;
-        const uint8_t sphereSubdivisions = 3u;
-        GeometryUtil::calculateVertexIndexCountsGeoSphere(sphereSubdivisions, sphereVertexCount, sphereIndexCount);
-
-        std::unique_ptr<uint16_t[]> pIndices = std::make_unique<uint16_t[]>(sphereIndexCount);
-        std::unique_ptr<Vertex[]> pVertices = std::make_unique<Vertex[]>(sphereVertexCount);
-        GeometryUtil::createGeoSphere(2.0f, sphereSubdivisions, pVertices.get(), pIndices.get());
+        static constexpr auto sphere = GeometryUtil::createStaticGeoSphere<3u, uint16_t>(2.0f, makeVertex);
+        const size_t sphereVertexCount = sphere.vertices.size();
+        const size_t sphereIndexCount = sphere.indices.size();
 
         // not thread safe
         size_t meshIndex = m_meshes.size();
         Mesh sphereMesh;
-        sphereMesh.createVertexBuffer(pVertices.get(), sphereVertexCount, sizeof(Vertex), m_pCommandList.Get());
-        sphereMesh.createIndexBuffer(pIndices.get(), sphereIndexCount, sizeof(uint16_t), m_pCommandList.Get());
+        sphereMesh.createVertexBuffer(sphere.vertices.data(), sphereVertexCount, sizeof(Vertex), m_pCommandList.Get());
+        sphereMesh.createIndexBuffer(sphere.indices.data(), sphereIndexCount, sizeof(uint16_t), m_pCommandList.Get());
+        sphereMesh.m_bounds = sphere.bounds;
         m_meshes.emplace_back(sphereMesh);
 
         // not thread safe
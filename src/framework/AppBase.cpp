@@ -1,9 +1,12 @@
 #include "AppBase.h"
 
 #include <cassert>
+#include <cmath>
 #include <exception>
+#include <fstream>
 
 #include "DebugUtil.h"
+#include "ProfileUtil.h"
 
 namespace
 {
@@ -86,27 +89,101 @@ int AppBase::run()
 {
     ShowWindow(m_hWnd, SW_SHOWDEFAULT);
 
+    // PROFILE_TRACE=<path> records the ProfileUtil zones and writes them as Chrome trace when the window closes
+    wchar_t tracePath[MAX_PATH] = {};
+    const DWORD tracePathLength = GetEnvironmentVariableW(L"PROFILE_TRACE", tracePath, MAX_PATH);
+    const bool isProfiling = tracePathLength > 0 && tracePathLength < MAX_PATH;
+    ProfileUtil::setEnabled(isProfiling);
+
+    // FRAME_STATS=<path> appends the frame time statistics of every window to a JSON lines file
+    wchar_t frameStatsPath[MAX_PATH] = {};
+    const DWORD frameStatsPathLength = GetEnvironmentVariableW(L"FRAME_STATS", frameStatsPath, MAX_PATH);
+    std::ofstream frameStatsFile;
+    if (frameStatsPathLength > 0 && frameStatsPathLength < MAX_PATH)
+    {
+        frameStatsFile.open(frameStatsPath, std::ios::app);
+    }
+
+    // the update and render phases are timed with the default time source, like m_timer
+    const double secondsPerTick = 1.0 / TimeUtil::getTicksPerSecond();
+
     MSG msg = {};
     m_timer.reset();
     m_timer.start();
-    initialize();
+    {
+        PROFILE_ZONE("AppBase::initialize");
+        initialize();
+    }
 
     while (msg.message != WM_QUIT) {
+        PROFILE_ZONE("AppBase::frame");
         m_timer.tick();
 
         if (PeekMessage(&msg, 0, 0, 0, PM_REMOVE))
         {
+            PROFILE_ZONE("AppBase::dispatchMessage");
             TranslateMessage(&msg);
             DispatchMessage(&msg);
         }
 
-        update(m_timer.getDelta());
-        render();
+        const int64_t updateStart = TimeUtil::getTicks();
+        if (m_fixedTimestep > 0.0f)
+        {
+            PROFILE_ZONE("AppBase::fixedUpdate");
+            m_fixedTimeAccumulator += m_timer.getDelta();
+            for (uint32_t step = 0; step < m_maxFixedStepsPerFrame && m_fixedTimeAccumulator >= m_fixedTimestep; ++step)
+            {
+                fixedUpdate(m_fixedTimestep);
+                m_fixedTimeAccumulator -= m_fixedTimestep;
+            }
+
+            // spiral of death clamp, keeps only the fraction of a step
+            if (m_fixedTimeAccumulator >= m_fixedTimestep)
+            {
+                m_fixedTimeAccumulator = std::fmod(m_fixedTimeAccumulator, m_fixedTimestep);
+            }
+            m_interpolationAlpha = m_fixedTimeAccumulator / m_fixedTimestep;
+        }
+        {
+            PROFILE_ZONE("AppBase::update");
+            update(m_timer.getDelta());
+        }
+        const int64_t renderStart = TimeUtil::getTicks();
+        {
+            PROFILE_ZONE("AppBase::render");
+            render();
+        }
+        const int64_t renderEnd = TimeUtil::getTicks();
+
+        const float updateSeconds = static_cast<float>(static_cast<double>(renderStart - updateStart) * secondsPerTick);
+        const float renderSeconds = static_cast<float>(static_cast<double>(renderEnd - renderStart) * secondsPerTick);
+        if (m_frameStats.addFrame(m_timer.getDelta(), updateSeconds, renderSeconds) && frameStatsFile.is_open())
+        {
+            m_frameStats.writeJsonLine(frameStatsFile);
+        }
+    }
+
+    if (isProfiling && !ProfileUtil::writeChromeTrace(tracePath))
+    {
+        OutputDebugString(L"could not write the profile trace\n");
     }
 
     return static_cast<int>(msg.wParam);
 }
 
+void AppBase::setFixedTimestep(const float stepSeconds, const uint32_t maxStepsPerFrame)
+{
+    m_fixedTimestep = stepSeconds;
+    m_maxFixedStepsPerFrame = maxStepsPerFrame;
+    m_fixedTimeAccumulator = stepSeconds;
+    m_interpolationAlpha = 0.0f;
+}
+
+float AppBase::getInterpolationAlpha() const
+{
+    return m_interpolationAlpha;
+}
+
 void AppBase::createWindow()
 {
     WNDCLASS windowClass = {};
@@ -10,6 +10,7 @@
 #include "dxgi1_6.h"
 #include "d3d12.h"
 
+#include "FrameStats.h"
 #include "Timer.h"
 
 class AppBase
@@ -32,6 +33,8 @@ public:
     int run();
     virtual void initialize() = 0;
     virtual void update(float dt) = 0;
+    // simulation work in fixed timestep mode, see setFixedTimestep
+    virtual void fixedUpdate(float /*step*/) {}
     virtual void render() = 0;
     virtual void onMouseDown(int16_t xPos, int16_t yPos, uint8_t buttons) = 0;
     virtual void onMouseUp(int16_t xPos, int16_t yPos, uint8_t buttons) = 0;
@@ -44,6 +47,14 @@ protected:
     D3D12_CPU_DESCRIPTOR_HANDLE getCurrentDepthStencilView() const;
     void flushCommandQueue();
 
+    // Makes run call fixedUpdate(stepSeconds) as often as the elapsed time requires before every update(dt) and
+    // render(), so the simulation cost no longer scales with the frame rate. Frames that would need more than
+    // maxStepsPerFrame steps drop the rest, the simulation then falls behind instead of taking ever longer frames. The
+    // first frame always runs one step. A step of 0 goes back to update and render only.
+    void setFixedTimestep(const float stepSeconds, const uint32_t maxStepsPerFrame = 5u);
+    // how far the rendered frame is past the last fixedUpdate in steps, in [0, 1), for blending the last two states
+    float getInterpolationAlpha() const;
+
     static constexpr size_t m_staticSamplerCount = 6;
     std::array<D3D12_STATIC_SAMPLER_DESC, m_staticSamplerCount> createDefaultStaticSamplerDescs() const;
 
@@ -78,4 +89,11 @@ protected:
     Microsoft::WRL::ComPtr<ID3D12Resource> m_depthStencilBuffer;
 
     Timer m_timer;
+    // filled by run with every frame, windows of one second
+    FrameStats m_frameStats;
+
+    float m_fixedTimestep = 0.0f;
+    uint32_t m_maxFixedStepsPerFrame = 5u;
+    float m_fixedTimeAccumulator = 0.0f;
+    float m_interpolationAlpha = 0.0f;
 };
\ No newline at end of file
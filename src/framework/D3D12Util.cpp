@@ -96,7 +96,7 @@ namespace D3D12Util
 
         return pCode;
     }
-    void createAndUploadBuffer(const void* const data, const size_t dataSize, ID3D12GraphicsCommandList* const commandList, ID3D12Resource** buffer, ID3D12Resource** uploadBuffer)
+    void* createBufferForUpload(const size_t dataSize, ID3D12GraphicsCommandList* const commandList, ID3D12Resource** buffer, ID3D12Resource** uploadBuffer)
     {
         D3D12_HEAP_PROPERTIES heapProperties = {};
         heapProperties.Type = D3D12_HEAP_TYPE_DEFAULT;
@@ -129,10 +129,17 @@ namespace D3D12Util
         // see https://docs.microsoft.com/en-us/windows/desktop/api/d3d12/nf-d3d12-id3d12resource-map
         D3D12_RANGE readRangeNoRead{ 0,0 };
         ThrowIfFailed((*uploadBuffer)->Map(0, &readRangeNoRead, &mappedBufferUpload));
+
+        // the copy only runs once the command list is executed, upload heaps may stay mapped while the GPU reads them
+        commandList->CopyResource(*buffer, *uploadBuffer);
+        return mappedBufferUpload;
+    }
+
+    void createAndUploadBuffer(const void* const data, const size_t dataSize, ID3D12GraphicsCommandList* const commandList, ID3D12Resource** buffer, ID3D12Resource** uploadBuffer)
+    {
+        void* const mappedBufferUpload = createBufferForUpload(dataSize, commandList, buffer, uploadBuffer);
         memcpy(mappedBufferUpload, data, dataSize);
         // nullptr range specifies the CPU might have written to the whole resource
         (*uploadBuffer)->Unmap(0, nullptr);
-
-        commandList->CopyResource(*buffer, *uploadBuffer);
     }
 }
\ No newline at end of file
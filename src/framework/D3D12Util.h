@@ -49,4 +49,10 @@ namespace D3D12Util
 
     void createAndUploadBuffer(const void* const data, const size_t dataSize,
         ID3D12GraphicsCommandList* const commandList, ID3D12Resource** buffer, ID3D12Resource** uploadBuffer);
+
+    // Creates the buffers like createAndUploadBuffer and records the copy, but returns the mapped upload buffer for
+    // the caller to fill before the command list is executed. The mapping lives as long as uploadBuffer. Upload heaps
+    // are usually write-combined, so never read it and write whole cache lines where possible.
+    void* createBufferForUpload(const size_t dataSize,
+        ID3D12GraphicsCommandList* const commandList, ID3D12Resource** buffer, ID3D12Resource** uploadBuffer);
 }
\ No newline at end of file
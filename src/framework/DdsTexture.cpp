@@ -5,9 +5,12 @@
 
 #include "DebugUtil.h"
 #include "D3D12Util.h"
+#include "ProfileUtil.h"
 
 void DdsTexture::createFromFileAndUpload(ID3D12GraphicsCommandList* const commandList, const wchar_t* const filename)
 {
+    PROFILE_ZONE("DdsTexture::createFromFileAndUpload");
+
     Microsoft::WRL::ComPtr<ID3D12Device> pDevice;
     ThrowIfFailed(commandList->GetDevice(IID_PPV_ARGS(&pDevice)));
 
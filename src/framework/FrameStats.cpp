@@ -0,0 +1,116 @@
+#include "FrameStats.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    const char* const phaseNames[FrameStats::PhaseCount] = { "frame", "update", "render" };
+
+    void writeSummary(std::ostream& stream, const char* const name, const FrameStats::Summary& summary)
+    {
+        stream << ", \"" << name << "\": {\"min\": " << summary.min << ", \"mean\": " << summary.mean << ", \"p50\": " << summary.p50
+            << ", \"p95\": " << summary.p95 << ", \"p99\": " << summary.p99 << ", \"max\": " << summary.max << "}";
+    }
+}
+
+FrameStats::FrameStats(const float windowSeconds) :
+    m_windowSeconds(windowSeconds)
+{}
+
+bool FrameStats::addFrame(const float frameSeconds, const float updateSeconds, const float renderSeconds)
+{
+    addSample(m_histograms[Frame], frameSeconds * 1000.0f);
+    addSample(m_histograms[Update], updateSeconds * 1000.0f);
+    addSample(m_histograms[Render], renderSeconds * 1000.0f);
+    ++m_sampleCount;
+
+    m_elapsedSeconds += frameSeconds;
+    if (m_elapsedSeconds < m_windowSeconds)
+    {
+        return false;
+    }
+
+    for (size_t phase = 0; phase < PhaseCount; ++phase)
+    {
+        Histogram& histogram = m_histograms[phase];
+        m_summaries[phase] = summarize(histogram);
+        std::fill(histogram.buckets.begin(), histogram.buckets.end(), 0u);
+        histogram.sum = 0.0;
+    }
+    m_frameCount = m_sampleCount;
+    m_sampleCount = 0u;
+    m_elapsedSeconds = 0.0f;
+    ++m_windowCount;
+    return true;
+}
+
+const FrameStats::Summary& FrameStats::getSummary(const Phase phase) const
+{
+    return m_summaries[phase];
+}
+
+size_t FrameStats::getFrameCount() const
+{
+    return m_frameCount;
+}
+
+size_t FrameStats::getWindowCount() const
+{
+    return m_windowCount;
+}
+
+void FrameStats::writeJsonLine(std::ostream& stream) const
+{
+    stream << "{\"window\": " << m_windowCount << ", \"frames\": " << m_frameCount;
+    for (size_t phase = 0; phase < PhaseCount; ++phase)
+    {
+        writeSummary(stream, phaseNames[phase], m_summaries[phase]);
+    }
+    stream << "}\n";
+}
+
+void FrameStats::addSample(Histogram& histogram, const float milliseconds) const
+{
+    // the first sample of a window resets min and max
+    if (m_sampleCount == 0u)
+    {
+        histogram.min = milliseconds;
+        histogram.max = milliseconds;
+    }
+    histogram.min = std::min(histogram.min, milliseconds);
+    histogram.max = std::max(histogram.max, milliseconds);
+    histogram.sum += milliseconds;
+
+    const float bucket = std::clamp(std::floor(milliseconds / histogramBucketMilliseconds), 0.0f, static_cast<float>(histogramBucketCount - 1u));
+    ++histogram.buckets[static_cast<size_t>(bucket)];
+}
+
+FrameStats::Summary FrameStats::summarize(const Histogram& histogram) const
+{
+    Summary summary = {};
+    if (m_sampleCount == 0u)
+    {
+        return summary;
+    }
+    summary.min = histogram.min;
+    summary.max = histogram.max;
+    summary.mean = static_cast<float>(histogram.sum / static_cast<double>(m_sampleCount));
+
+    // nearest rank percentiles at the bucket centers, clamped since the outer buckets are only partly covered
+    const std::array<float*, 3> percentiles = { &summary.p50, &summary.p95, &summary.p99 };
+    const std::array<double, 3> fractions = { 0.50, 0.95, 0.99 };
+    size_t percentileIndex = 0;
+    size_t cumulativeCount = 0;
+    for (size_t bucket = 0; bucket < histogramBucketCount && percentileIndex < percentiles.size(); ++bucket)
+    {
+        cumulativeCount += histogram.buckets[bucket];
+        while (percentileIndex < percentiles.size() && static_cast<double>(cumulativeCount) >= std::ceil(fractions[percentileIndex] * static_cast<double>(m_sampleCount)))
+        {
+            const float center = (static_cast<float>(bucket) + 0.5f) * histogramBucketMilliseconds;
+            *percentiles[percentileIndex] = std::clamp(center, summary.min, summary.max);
+            ++percentileIndex;
+        }
+    }
+    return summary;
+}
\ No newline at end of file
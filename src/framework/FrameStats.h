@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <cinttypes>
+#include <cstddef>
+#include <ostream>
+#include <vector>
+
+// Frame time distributions over rolling windows, for the whole frame and the update and render phases. Samples go into
+// fixed histograms of histogramBucketCount buckets of histogramBucketMilliseconds, so adding a frame never allocates
+// and the percentiles are exact up to the bucket width. Longer samples land in the last bucket, min, mean and max stay
+// exact.
+class FrameStats
+{
+public:
+    enum Phase : uint8_t
+    {
+        Frame,
+        Update,
+        Render,
+        PhaseCount,
+    };
+
+    static constexpr float histogramBucketMilliseconds = 0.01f;
+    static constexpr size_t histogramBucketCount = 10000u;
+
+    // milliseconds
+    struct Summary
+    {
+        float min;
+        float mean;
+        float p50;
+        float p95;
+        float p99;
+        float max;
+    };
+
+    explicit FrameStats(const float windowSeconds = 1.0f);
+
+    // Adds the durations of one frame in seconds. Returns true when they complete a window, whose stats getSummary
+    // returns until the next window completes.
+    bool addFrame(const float frameSeconds, const float updateSeconds, const float renderSeconds);
+
+    // of the last completed window
+    const Summary& getSummary(const Phase phase) const;
+    size_t getFrameCount() const;
+    size_t getWindowCount() const;
+
+    // the last completed window as one JSON object and a line break, e.g. for a JSON lines log
+    void writeJsonLine(std::ostream& stream) const;
+private:
+    struct Histogram
+    {
+        std::vector<uint32_t> buckets = std::vector<uint32_t>(histogramBucketCount, 0u);
+        double sum = 0.0;
+        float min = 0.0f;
+        float max = 0.0f;
+    };
+
+    void addSample(Histogram& histogram, const float milliseconds) const;
+    Summary summarize(const Histogram& histogram) const;
+
+    float m_windowSeconds;
+    float m_elapsedSeconds = 0.0f;
+    size_t m_sampleCount = 0u;
+    std::array<Histogram, PhaseCount> m_histograms;
+
+    std::array<Summary, PhaseCount> m_summaries = {};
+    size_t m_frameCount = 0u;
+    size_t m_windowCount = 0u;
+};
\ No newline at end of file
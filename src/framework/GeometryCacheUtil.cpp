@@ -0,0 +1,272 @@
+#include "GeometryCacheUtil.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <system_error>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include "windows.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    constexpr uint32_t cacheFileMagic = 0x4D4F4547u; // "GEOM"
+
+    // vertex and index data start at cache line boundaries of the page aligned mapping
+    constexpr uint64_t dataAlignment = 64u;
+
+    struct CacheFileHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t key;
+        uint64_t vertexCount;
+        uint64_t vertexSize;
+        uint64_t vertexOffset;
+        uint64_t indexCount;
+        uint64_t indexSize;
+        uint64_t indexOffset;
+        uint64_t fileSize;
+    };
+
+    uint64_t alignUp(const uint64_t value)
+    {
+        return (value + dataAlignment - 1u) & ~(dataAlignment - 1u);
+    }
+
+    std::filesystem::path getCacheFilePath(const std::filesystem::path& directory, const uint64_t key)
+    {
+        char fileName[32];
+        std::snprintf(fileName, sizeof(fileName), "%016llx.mesh", static_cast<unsigned long long>(key));
+        return directory / fileName;
+    }
+
+    std::atomic<uint32_t> s_temporaryFileCount(0u);
+
+    // unique per process and call, so concurrent writers of one key never write into the same temporary file
+    std::filesystem::path getTemporaryFilePath(const std::filesystem::path& path)
+    {
+#if defined(_WIN32)
+        const unsigned long processId = GetCurrentProcessId();
+#else
+        const unsigned long processId = static_cast<unsigned long>(getpid());
+#endif
+        char suffix[48];
+        std::snprintf(suffix, sizeof(suffix), ".%lu.%u.tmp", processId, static_cast<unsigned int>(s_temporaryFileCount.fetch_add(1u, std::memory_order_relaxed)));
+        std::filesystem::path temporaryPath = path;
+        temporaryPath += suffix;
+        return temporaryPath;
+    }
+
+    bool isValidHeader(const CacheFileHeader& header, const uint64_t key, const size_t fileSize)
+    {
+        if (header.magic != cacheFileMagic || header.version != GeometryCacheUtil::cacheFileVersion || header.key != key || header.fileSize != fileSize)
+        {
+            return false;
+        }
+
+        // sizes are checked with divisions, so corrupt counts cannot overflow past the checks
+        if (header.vertexOffset < sizeof(CacheFileHeader) || header.indexOffset < header.vertexOffset || header.indexOffset > fileSize ||
+            header.vertexSize == 0u || header.vertexCount > (header.indexOffset - header.vertexOffset) / header.vertexSize ||
+            (header.indexSize != sizeof(uint16_t) && header.indexSize != sizeof(uint32_t)) ||
+            header.indexCount > (fileSize - header.indexOffset) / header.indexSize)
+        {
+            return false;
+        }
+        return true;
+    }
+}
+
+namespace GeometryCacheUtil
+{
+    uint64_t hashBytes(const void* const data, const size_t size, const uint64_t seed)
+    {
+        const uint8_t* const pBytes = static_cast<const uint8_t*>(data);
+        uint64_t hash = seed;
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash = (hash ^ pBytes[i]) * 1099511628211ull;
+        }
+        return hash;
+    }
+
+    uint64_t hashString(const char* const string, const uint64_t seed)
+    {
+        return hashBytes(string, std::strlen(string), seed);
+    }
+
+    uint64_t hashVertexDesc(const GeometryUtil::VertexDesc& vertexDesc, const uint64_t seed)
+    {
+        uint64_t hash = hashValue(vertexDesc.attributeCount, seed);
+        for (size_t attribute = 0; attribute < vertexDesc.attributeCount; ++attribute)
+        {
+            hash = hashValue(vertexDesc.pAttributeDescs[attribute].attributeType, hash);
+            hash = hashValue(vertexDesc.pAttributeDescs[attribute].attributeByteOffset, hash);
+        }
+        hash = hashValue(vertexDesc.stride, hash);
+        hash = hashValue(vertexDesc.positionBoundsMin.x, hash);
+        hash = hashValue(vertexDesc.positionBoundsMin.y, hash);
+        hash = hashValue(vertexDesc.positionBoundsMin.z, hash);
+        hash = hashValue(vertexDesc.positionBoundsMax.x, hash);
+        hash = hashValue(vertexDesc.positionBoundsMax.y, hash);
+        return hashValue(vertexDesc.positionBoundsMax.z, hash);
+    }
+
+    MappedMesh::~MappedMesh()
+    {
+        unmap();
+    }
+
+    bool MappedMesh::map(const std::filesystem::path& directory, const uint64_t key)
+    {
+        unmap();
+
+        const std::filesystem::path path = getCacheFilePath(directory, key);
+        void* pData = nullptr;
+        size_t size = 0u;
+#if defined(_WIN32)
+        const HANDLE hFile = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (hFile == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(hFile, &fileSize) || fileSize.QuadPart < static_cast<LONGLONG>(sizeof(CacheFileHeader)))
+        {
+            CloseHandle(hFile);
+            return false;
+        }
+        size = static_cast<size_t>(fileSize.QuadPart);
+
+        // the view keeps the mapping and the file open
+        const HANDLE hMapping = CreateFileMappingW(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(hFile);
+        if (hMapping == nullptr)
+        {
+            return false;
+        }
+        pData = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(hMapping);
+        if (pData == nullptr)
+        {
+            return false;
+        }
+#else
+        const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            return false;
+        }
+        struct stat fileStat;
+        if (fstat(fd, &fileStat) != 0 || fileStat.st_size < static_cast<off_t>(sizeof(CacheFileHeader)))
+        {
+            close(fd);
+            return false;
+        }
+        size = static_cast<size_t>(fileStat.st_size);
+
+        // the mapping keeps the file open
+        pData = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (pData == MAP_FAILED)
+        {
+            return false;
+        }
+        // everything gets uploaded right away, so start reading ahead
+        madvise(pData, size, MADV_WILLNEED);
+#endif
+        m_pData = pData;
+        m_size = size;
+
+        CacheFileHeader header;
+        std::memcpy(&header, m_pData, sizeof(header));
+        if (!isValidHeader(header, key, m_size))
+        {
+            unmap();
+            return false;
+        }
+
+        const uint8_t* const pBytes = static_cast<const uint8_t*>(m_pData);
+        m_view.pVertices = pBytes + header.vertexOffset;
+        m_view.vertexCount = static_cast<size_t>(header.vertexCount);
+        m_view.vertexSize = static_cast<size_t>(header.vertexSize);
+        m_view.pIndices = pBytes + header.indexOffset;
+        m_view.indexCount = static_cast<size_t>(header.indexCount);
+        m_view.indexSize = static_cast<size_t>(header.indexSize);
+        return true;
+    }
+
+    void MappedMesh::unmap()
+    {
+        if (m_pData != nullptr)
+        {
+#if defined(_WIN32)
+            UnmapViewOfFile(m_pData);
+#else
+            munmap(m_pData, m_size);
+#endif
+        }
+        m_pData = nullptr;
+        m_size = 0u;
+        m_view = {};
+    }
+
+    bool storeMesh(const std::filesystem::path& directory, const uint64_t key, const MeshView& mesh)
+    {
+        CacheFileHeader header = {};
+        header.magic = cacheFileMagic;
+        header.version = cacheFileVersion;
+        header.key = key;
+        header.vertexCount = mesh.vertexCount;
+        header.vertexSize = mesh.vertexSize;
+        header.vertexOffset = alignUp(sizeof(CacheFileHeader));
+        header.indexCount = mesh.indexCount;
+        header.indexSize = mesh.indexSize;
+        header.indexOffset = alignUp(header.vertexOffset + header.vertexCount * header.vertexSize);
+        header.fileSize = header.indexOffset + header.indexCount * header.indexSize;
+
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+        if (error)
+        {
+            return false;
+        }
+
+        const std::filesystem::path path = getCacheFilePath(directory, key);
+        const std::filesystem::path temporaryPath = getTemporaryFilePath(path);
+        {
+            std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+            const char padding[dataAlignment] = {};
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(padding, static_cast<std::streamsize>(header.vertexOffset - sizeof(header)));
+            file.write(static_cast<const char*>(mesh.pVertices), static_cast<std::streamsize>(header.vertexCount * header.vertexSize));
+            file.write(padding, static_cast<std::streamsize>(header.indexOffset - header.vertexOffset - header.vertexCount * header.vertexSize));
+            file.write(static_cast<const char*>(mesh.pIndices), static_cast<std::streamsize>(header.indexCount * header.indexSize));
+            file.close();
+            if (!file)
+            {
+                std::filesystem::remove(temporaryPath, error);
+                return false;
+            }
+        }
+
+        // replaces the file of an older launch or another writer of the same key, on Windows this fails while it is mapped
+        std::filesystem::rename(temporaryPath, path, error);
+        if (error)
+        {
+            std::filesystem::remove(temporaryPath, error);
+            return false;
+        }
+        return true;
+    }
+}
\ No newline at end of file
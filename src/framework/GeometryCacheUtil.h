@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cinttypes>
+#include <cstddef>
+#include <filesystem>
+#include <type_traits>
+
+#include "GeometryUtil.h"
+
+// Stores generated meshes in binary files that later launches map into memory instead of generating them again. Files
+// are named after a key of everything that went into the mesh, so changed parameters or vertex layouts simply miss.
+namespace GeometryCacheUtil
+{
+    // bump whenever the file layout changes
+    constexpr uint32_t cacheFileVersion = 1u;
+
+    // keys are FNV-1a hashes, chain them by passing the previous key as seed
+    constexpr uint64_t keySeed = 14695981039346656037ull;
+
+    uint64_t hashBytes(const void* const data, const size_t size, const uint64_t seed = keySeed);
+
+    template <typename T>
+    uint64_t hashValue(const T& value, const uint64_t seed = keySeed)
+    {
+        // structs may contain padding, hash their members instead
+        static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>, "hashValue only supports scalars");
+        return hashBytes(&value, sizeof(T), seed);
+    }
+
+    uint64_t hashString(const char* const string, const uint64_t seed = keySeed);
+
+    // attribute types and offsets, stride and position bounds
+    uint64_t hashVertexDesc(const GeometryUtil::VertexDesc& vertexDesc, const uint64_t seed = keySeed);
+
+    struct MeshView
+    {
+        const void* pVertices;
+        size_t vertexCount;
+        size_t vertexSize;
+        const void* pIndices;
+        size_t indexCount;
+        size_t indexSize;
+    };
+
+    // read only mapping of a cache file, the data stays valid until the mapping is unmapped or destroyed
+    class MappedMesh
+    {
+    public:
+        MappedMesh() = default;
+        MappedMesh(const MappedMesh&) = delete;
+        MappedMesh& operator=(const MappedMesh&) = delete;
+        ~MappedMesh();
+
+        // maps the file of key in directory, returns false if it is missing or was not written for key
+        bool map(const std::filesystem::path& directory, const uint64_t key);
+        void unmap();
+
+        const MeshView& getView() const { return m_view; }
+
+    private:
+        void* m_pData = nullptr;
+        size_t m_size = 0u;
+        MeshView m_view = {};
+    };
+
+    // Writes the mesh to a temporary file named after the process and call and renames it, so concurrent writers of
+    // the same key, in one or several processes, never interleave and readers never map partial files. The directory
+    // is created if needed. Returns false and removes the temporary file if writing or renaming failed, the cache is
+    // optional.
+    bool storeMesh(const std::filesystem::path& directory, const uint64_t key, const MeshView& mesh);
+}
\ No newline at end of file
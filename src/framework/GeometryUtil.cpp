@@ -1,351 +1,336 @@
 #include "GeometryUtil.h"
 
-#include <cstring>
-#include <cmath>
-#include <unordered_map>
-
-#include <algorithm>
-#include <memory>
-
-#include "DirectXMath.h"
-
-namespace GeometryUtil
+namespace
 {
-    void calculateVertexIndexCountsGeoSphere(uint8_t subdivisions, size_t& vertexCount, size_t& indexCount)
+    // vertices convertVertices handles per attribute before moving on to the next one, a multiple of the SIMD width
+    // that keeps the source and destination vertices of a block in L1
+    constexpr size_t conversionBlockSize = 64u;
+
+    // float attribute a compact encoding is converted from
+    GeometryUtil::VertexAttributeType getFloatAttributeType(const GeometryUtil::VertexAttributeType attributeType)
     {
-        /*
-        // Base icosahedron has 12 vertices, 20 triangles and 30 edges. Each subdivision replaces one triangle by
-        // 4 triangles (think triforce) and splits the edges in two halfs, adding one vertex per edge and 3 edges
-        // inside of each triangle.
-        vertexCount = 12;
-        size_t edgeCount = 30;
-        size_t triangleCount = 20;
-        for (uint8_t i = 0; i < subdivisions; ++i)
+        switch (attributeType)
         {
-            vertexCount += edgeCount;
-            edgeCount = 2*edgeCount + 3*triangleCount;
-            triangleCount *= 4;
+        case GeometryUtil::VertexAttributeType::POSITION_UNORM16:
+            return GeometryUtil::VertexAttributeType::POSITION;
+        case GeometryUtil::VertexAttributeType::UV_HALF:
+            return GeometryUtil::VertexAttributeType::UV;
+        case GeometryUtil::VertexAttributeType::NORMAL_OCT_SNORM16:
+            return GeometryUtil::VertexAttributeType::NORMAL;
+        default:
+            return attributeType;
         }
-        // Each vertex is part of 5 triangles
-        indexCount = 5*vertexCount;
-        */
-        // solved recurrence relation, vertex count is 2 + 10*4^(subdivisions)
-        // 4^x = 1 << (x*2)
-        vertexCount = 2 + 10 * (1 << (subdivisions * 2));
-        indexCount = 3 * 20 * (1 << (subdivisions * 2));
     }
 
-    void createGeoSphere(const float radius, const uint8_t subdivisions, void* const vertices, void* const indices, const VertexDesc& vertexDesc)
+    struct AttributeConversion
     {
-        const float phi = 1.6180339887f;
-        const float distFromCenter = std::sqrtf(phi * phi + 1.0f);
-        const float normalizationFactor = radius / distFromCenter;
-        const float phiNorm = phi * normalizationFactor;
-        const float oneNorm = normalizationFactor;
+        GeometryUtil::VertexAttributeType dstAttributeType;
+        size_t dstByteOffset;
+        size_t srcByteOffset;
+    };
 
-        const DirectX::XMFLOAT3 baseVertexPositions[] = {
-            {0.0f,  phiNorm,  oneNorm},
-            {0.0f,  phiNorm, -oneNorm},
-            {0.0f, -phiNorm,  oneNorm},
-            {0.0f, -phiNorm, -oneNorm},
-            {-oneNorm, 0.0f,  phiNorm},
-            { oneNorm, 0.0f,  phiNorm},
-            {-oneNorm, 0.0f, -phiNorm},
-            { oneNorm, 0.0f, -phiNorm},
-            {-phiNorm,  oneNorm, 0.0f},
-            { phiNorm,  oneNorm, 0.0f},
-            {-phiNorm, -oneNorm, 0.0f},
-            { phiNorm, -oneNorm, 0.0f},
-        };
+    // every attribute type other than UNINITIALIZED once, POSITION_UNORM16 is the last type, so convertVertices keeps
+    // its conversions on the stack
+    constexpr size_t maxAttributeConversionCount = static_cast<size_t>(GeometryUtil::VertexAttributeType::POSITION_UNORM16);
 
-        const std::unique_ptr<uint8_t[]> baseVertexBytes = std::make_unique<uint8_t[]>(12u * vertexDesc.stride);
+    // calculateBounds keeps one partial result per range on the stack, so per frame calls never allocate
+    constexpr size_t maxBoundsRangeCount = 64u;
 
-        size_t vertexPositionByteOffset = 0u;
-        for (size_t i = 0; i < vertexDesc.attributeCount; ++i)
+    // loadPosition(vertexIndex) returns the position of a vertex with w set to 0
+    template <typename LoadPosition>
+    GeometryUtil::Bounds calculatePositionBounds(const size_t vertexCount, const size_t threadCount, const LoadPosition& loadPosition)
+    {
+        GeometryUtil::Bounds bounds = {};
+        if (vertexCount == 0u)
         {
-            if (vertexDesc.pAttributeDescs[i].attributeType == VertexAttributeType::POSITION)
-            {
-                assert(vertexPositionByteOffset == 0);
-                vertexPositionByteOffset = vertexDesc.pAttributeDescs[i].attributeByteOffset;
-            }
+            return bounds;
         }
 
+        // every range gets its own thread and partial result
+        const size_t boundsThreadCount = ThreadUtil::getThreadCount(vertexCount, threadCount);
+        const size_t rangeCount = std::min({ boundsThreadCount, maxBoundsRangeCount, vertexCount });
+        const auto getRangeBegin = [vertexCount, rangeCount](const size_t range) { return vertexCount * range / rangeCount; };
+
+        // Box pass. Four vertices are reduced with each other before they meet the accumulators, so the min and max
+        // chains advance once per four loads.
+        DirectX::XMFLOAT3 rangeMins[maxBoundsRangeCount];
+        DirectX::XMFLOAT3 rangeMaxs[maxBoundsRangeCount];
+        ThreadUtil::parallelFor(rangeCount, [&](const size_t beginRange, const size_t endRange)
         {
-            uint8_t* curVertexByte = reinterpret_cast<uint8_t*>(baseVertexBytes.get());
-            for (size_t baseVertexId = 0; baseVertexId < 12u; ++baseVertexId)
+            for (size_t range = beginRange; range < endRange; ++range)
             {
-                const auto& vertexPosition = baseVertexPositions[baseVertexId];
-                auto vertexNormal = baseVertexPositions[baseVertexId];
-                vertexNormal.x *= 1.0f / radius;
-                vertexNormal.y *= 1.0f / radius;
-                vertexNormal.z *= 1.0f / radius;
-                for (size_t i = 0; i < vertexDesc.attributeCount; ++i)
+                const size_t end = getRangeBegin(range + 1u);
+                size_t vertexIndex = getRangeBegin(range);
+                DirectX::XMVECTOR xmvMin = loadPosition(vertexIndex);
+                DirectX::XMVECTOR xmvMax = xmvMin;
+                for (; vertexIndex + 4u <= end; vertexIndex += 4u)
                 {
-                    const auto& desc = vertexDesc.pAttributeDescs[i];
-                    switch (desc.attributeType)
-                    {
-                    case VertexAttributeType::POSITION:
-                    {
-                        DirectX::XMFLOAT3* pos = reinterpret_cast<DirectX::XMFLOAT3*>(curVertexByte + desc.attributeByteOffset);
-                        *pos = vertexPosition;
-                    }
-                    break;
-                    case VertexAttributeType::UV:
-                    {
-                        DirectX::XMFLOAT2* uv = reinterpret_cast<DirectX::XMFLOAT2*>(curVertexByte + desc.attributeByteOffset);
-                        *uv = {
-                            DirectX::XMScalarACos(vertexNormal.y) / DirectX::XM_PI,
-                            0.5f + std::atan2f(vertexNormal.x, vertexNormal.z) / DirectX::XM_2PI,
-                        };
-                    }
-                    break;
-                    case VertexAttributeType::NORMAL:
-                    {
-                        DirectX::XMFLOAT3* normal = reinterpret_cast<DirectX::XMFLOAT3*>(curVertexByte + desc.attributeByteOffset);
-                        *normal = vertexNormal;
-                    }
-                    break;
-                    }
+                    const DirectX::XMVECTOR xmvPosition0 = loadPosition(vertexIndex);
+                    const DirectX::XMVECTOR xmvPosition1 = loadPosition(vertexIndex + 1u);
+                    const DirectX::XMVECTOR xmvPosition2 = loadPosition(vertexIndex + 2u);
+                    const DirectX::XMVECTOR xmvPosition3 = loadPosition(vertexIndex + 3u);
+                    xmvMin = DirectX::XMVectorMin(xmvMin, DirectX::XMVectorMin(DirectX::XMVectorMin(xmvPosition0, xmvPosition1), DirectX::XMVectorMin(xmvPosition2, xmvPosition3)));
+                    xmvMax = DirectX::XMVectorMax(xmvMax, DirectX::XMVectorMax(DirectX::XMVectorMax(xmvPosition0, xmvPosition1), DirectX::XMVectorMax(xmvPosition2, xmvPosition3)));
                 }
-                curVertexByte += vertexDesc.stride;
+                for (; vertexIndex < end; ++vertexIndex)
+                {
+                    const DirectX::XMVECTOR xmvPosition = loadPosition(vertexIndex);
+                    xmvMin = DirectX::XMVectorMin(xmvMin, xmvPosition);
+                    xmvMax = DirectX::XMVectorMax(xmvMax, xmvPosition);
+                }
+                DirectX::XMStoreFloat3(&rangeMins[range], xmvMin);
+                DirectX::XMStoreFloat3(&rangeMaxs[range], xmvMax);
             }
-        }
+        }, rangeCount);
 
-        constexpr uint16_t baseIndices[] = {
-            0, 5, 4,
-            0, 9, 5,
-            1, 9, 0,
-            1, 7, 9,
-            1, 6, 7,
-            1, 8, 6,
-            1, 0, 8,
-            0, 4, 8,
-            5, 9, 11,
-            7, 11, 9,
-            4, 10, 8,
-            6, 8, 10,
-            2, 4, 5,
-            2, 5, 11,
-            2, 11, 3,
-            3, 11, 7,
-            3, 7, 6,
-            3, 6, 10,
-            2, 3, 10,
-            2, 10, 4,
-        };
-
-        std::unique_ptr<uint8_t[]> tmpVertexBytes;
-        std::unique_ptr<uint16_t[]> tmpIndices;
-
-        if (subdivisions > 0u)
+        DirectX::XMVECTOR xmvMin = DirectX::XMLoadFloat3(&rangeMins[0]);
+        DirectX::XMVECTOR xmvMax = DirectX::XMLoadFloat3(&rangeMaxs[0]);
+        for (size_t range = 1u; range < rangeCount; ++range)
         {
-            // tmp buffers need enough space for second to last iteration
-            size_t tmpVertexBufferVertexCount;
-            size_t tmpIndexBufferIndexCount;
-            calculateVertexIndexCountsGeoSphere(subdivisions - 1, tmpVertexBufferVertexCount, tmpIndexBufferIndexCount);
-            tmpVertexBytes = std::make_unique<uint8_t[]>(tmpVertexBufferVertexCount * vertexDesc.stride);
-            tmpIndices = std::make_unique<uint16_t[]>(tmpIndexBufferIndexCount);
+            xmvMin = DirectX::XMVectorMin(xmvMin, DirectX::XMLoadFloat3(&rangeMins[range]));
+            xmvMax = DirectX::XMVectorMax(xmvMax, DirectX::XMLoadFloat3(&rangeMaxs[range]));
         }
+        const DirectX::XMVECTOR xmvCenter = DirectX::XMVectorScale(DirectX::XMVectorAdd(xmvMin, xmvMax), 0.5f);
 
-        // last iteration should target final buffer so starting dst/src depends on number of subdivisions
-        uint8_t* dstVertices = subdivisions % 2 == 1 ? reinterpret_cast<uint8_t*>(vertices) : tmpVertexBytes.get();
-        uint16_t* dstIndices = subdivisions % 2 == 1 ? reinterpret_cast<uint16_t*>(indices) : tmpIndices.get();
-        uint8_t* srcVertices = subdivisions % 2 == 1 ? tmpVertexBytes.get() : reinterpret_cast<uint8_t*>(vertices);
-        uint16_t* srcIndices = subdivisions % 2 == 1 ? tmpIndices.get() : reinterpret_cast<uint16_t*>(indices);
-
-        std::memcpy(srcVertices, baseVertexBytes.get(), (12u * vertexDesc.stride));
-        std::memcpy(srcIndices, baseIndices, sizeof(baseIndices));
-
-        if (subdivisions > 0u)
+        // Radius pass. Offsets of four vertices are transposed into x, y and z vectors, so four squared distances take
+        // three multiplies and two adds.
+        float rangeMaxDistancesSq[maxBoundsRangeCount];
+        ThreadUtil::parallelFor(rangeCount, [&](const size_t beginRange, const size_t endRange)
         {
-            size_t totalVertexCount;
-            size_t totalIndexCount;
-            calculateVertexIndexCountsGeoSphere(subdivisions, totalVertexCount, totalIndexCount);
-
-            std::unordered_map<size_t, uint16_t> edgesToNewIndex;
-            // each vertex is part of 5 edges, but each edge has 2 end vertices
-            edgesToNewIndex.reserve((totalVertexCount * 5) / 2);
-
-            size_t vertexCopyOffset = 0;
-            size_t indexCopyOffset = 0;
-
-            for (uint8_t iteration = 0; iteration < subdivisions; ++iteration)
+            for (size_t range = beginRange; range < endRange; ++range)
             {
-                size_t vertexCountLastIteration;
-                size_t indexCountLastIteration;
-                calculateVertexIndexCountsGeoSphere(iteration, vertexCountLastIteration, indexCountLastIteration);
-
-                // copy new vertices from last iteration
-                std::memcpy(dstVertices + vertexCopyOffset * vertexDesc.stride, srcVertices + vertexCopyOffset * vertexDesc.stride, (vertexCountLastIteration - vertexCopyOffset) * vertexDesc.stride);
-                std::memcpy(dstIndices + indexCopyOffset, srcIndices + indexCopyOffset, (indexCountLastIteration - indexCopyOffset) * sizeof(uint16_t));
-
-                uint16_t nextFreeVertexIndex = static_cast<uint16_t>(vertexCountLastIteration);
-                vertexCopyOffset = vertexCountLastIteration;
-                indexCopyOffset = indexCountLastIteration;
-
-                size_t dstTriangleIndex = 0;
-                for (size_t srcTriangleIndex = 0; srcTriangleIndex < indexCountLastIteration; srcTriangleIndex += 3)
+                const size_t end = getRangeBegin(range + 1u);
+                size_t vertexIndex = getRangeBegin(range);
+                DirectX::XMVECTOR xmvMaxDistanceSq = DirectX::XMVectorZero();
+                for (; vertexIndex + 4u <= end; vertexIndex += 4u)
                 {
-                    const uint16_t *const triangle = &srcIndices[srcTriangleIndex];
-                    const DirectX::XMFLOAT3 triangleVertexPositions[] = {
-                        *reinterpret_cast<DirectX::XMFLOAT3*>(srcVertices + triangle[0] * vertexDesc.stride + vertexPositionByteOffset),
-                        *reinterpret_cast<DirectX::XMFLOAT3*>(srcVertices + triangle[1] * vertexDesc.stride + vertexPositionByteOffset),
-                        *reinterpret_cast<DirectX::XMFLOAT3*>(srcVertices + triangle[2] * vertexDesc.stride + vertexPositionByteOffset),
-                    };
+                    DirectX::XMMATRIX offsets;
+                    offsets.r[0] = DirectX::XMVectorSubtract(loadPosition(vertexIndex), xmvCenter);
+                    offsets.r[1] = DirectX::XMVectorSubtract(loadPosition(vertexIndex + 1u), xmvCenter);
+                    offsets.r[2] = DirectX::XMVectorSubtract(loadPosition(vertexIndex + 2u), xmvCenter);
+                    offsets.r[3] = DirectX::XMVectorSubtract(loadPosition(vertexIndex + 3u), xmvCenter);
+                    offsets = DirectX::XMMatrixTranspose(offsets);
+                    const DirectX::XMVECTOR xmvDistanceSq = DirectX::XMVectorMultiplyAdd(offsets.r[0], offsets.r[0],
+                        DirectX::XMVectorMultiplyAdd(offsets.r[1], offsets.r[1], DirectX::XMVectorMultiply(offsets.r[2], offsets.r[2])));
+                    xmvMaxDistanceSq = DirectX::XMVectorMax(xmvMaxDistanceSq, xmvDistanceSq);
+                }
+                for (; vertexIndex < end; ++vertexIndex)
+                {
+                    const DirectX::XMVECTOR xmvOffset = DirectX::XMVectorSubtract(loadPosition(vertexIndex), xmvCenter);
+                    xmvMaxDistanceSq = DirectX::XMVectorMax(xmvMaxDistanceSq, DirectX::XMVector3LengthSq(xmvOffset));
+                }
+                DirectX::XMFLOAT4A maxDistancesSq;
+                DirectX::XMStoreFloat4A(&maxDistancesSq, xmvMaxDistanceSq);
+                rangeMaxDistancesSq[range] = std::max({ maxDistancesSq.x, maxDistancesSq.y, maxDistancesSq.z, maxDistancesSq.w });
+            }
+        }, rangeCount);
+
+        const float maxDistanceSq = *std::max_element(rangeMaxDistancesSq, rangeMaxDistancesSq + rangeCount);
+        DirectX::XMStoreFloat3(&bounds.aabbMin, xmvMin);
+        DirectX::XMStoreFloat3(&bounds.aabbMax, xmvMax);
+        DirectX::XMStoreFloat3(&bounds.sphereCenter, xmvCenter);
+        bounds.sphereRadius = std::sqrt(maxDistanceSq);
+        return bounds;
+    }
+}
 
-                    uint16_t newVertexIndices[3] = {};
+namespace GeometryUtil
+{
+    template <typename IndexType>
+    Bounds createGeoSphere(const float radius, const uint8_t subdivisions, void* const vertices, IndexType* const indices, const VertexDesc& vertexDesc)
+    {
+        return createGeoSphere(radius, subdivisions, vertices, indices, RuntimeVertexWriter(vertexDesc));
+    }
 
-                    for (size_t edgeIndex = 0; edgeIndex < 3u; ++edgeIndex)
-                    {
-                        uint16_t i0 = triangle[edgeIndex];
-                        uint16_t i1 = triangle[(edgeIndex + 1) % 3];
+    template Bounds createGeoSphere<uint16_t>(const float, const uint8_t, void* const, uint16_t* const, const VertexDesc&);
+    template Bounds createGeoSphere<uint32_t>(const float, const uint8_t, void* const, uint32_t* const, const VertexDesc&);
 
-                        if (i0 > i1)
-                        {
-                            std::swap(i0, i1);
-                        }
+    template <typename IndexType>
+    Bounds createGeoSphereLodChain(const float radius, const uint8_t maxSubdivisions, void* const vertices, IndexType* const indices, GeoSphereLod* const lods, const VertexDesc& vertexDesc)
+    {
+        return createGeoSphereLodChain(radius, maxSubdivisions, vertices, indices, lods, RuntimeVertexWriter(vertexDesc));
+    }
 
-                        const size_t key = i0 << 16 | i1;
-                        uint16_t& newVertexIndex = edgesToNewIndex[key];
+    template Bounds createGeoSphereLodChain<uint16_t>(const float, const uint8_t, void* const, uint16_t* const, GeoSphereLod* const, const VertexDesc&);
+    template Bounds createGeoSphereLodChain<uint32_t>(const float, const uint8_t, void* const, uint32_t* const, GeoSphereLod* const, const VertexDesc&);
 
-                        if (newVertexIndex == 0)
-                        {
-                            newVertexIndex = nextFreeVertexIndex++;
-                            DirectX::XMVECTOR xmvPos0 = DirectX::XMLoadFloat3(&triangleVertexPositions[edgeIndex]);
-                            DirectX::XMVECTOR xmvPos1 = DirectX::XMLoadFloat3(&triangleVertexPositions[(edgeIndex + 1) % 3]);
-                            xmvPos0 = DirectX::XMVectorAdd(xmvPos0, xmvPos1);
-                            xmvPos0 = DirectX::XMVector3Normalize(xmvPos0);
-                            DirectX::XMFLOAT3 newVertexNormal;
-                            DirectX::XMStoreFloat3(&newVertexNormal, xmvPos0);
+    template <typename IndexType>
+    Bounds createSquare(const float width, const uint32_t vertexCountPerSide, void* const vertices, IndexType* const indices, const VertexDesc& vertexDesc)
+    {
+        return createSquare(width, vertexCountPerSide, vertices, indices, RuntimeVertexWriter(vertexDesc));
+    }
 
-                            xmvPos0 = DirectX::XMVectorScale(xmvPos0, radius);
-                            DirectX::XMFLOAT3 newVertexPosition;
-                            DirectX::XMStoreFloat3(&newVertexPosition, xmvPos0);
+    template Bounds createSquare<uint16_t>(const float, const uint32_t, void* const, uint16_t* const, const VertexDesc&);
+    template Bounds createSquare<uint32_t>(const float, const uint32_t, void* const, uint32_t* const, const VertexDesc&);
 
-                            uint8_t* curVertexByte = dstVertices + newVertexIndex * vertexDesc.stride;
-                            for (size_t i = 0; i < vertexDesc.attributeCount; ++i)
-                            {
-                                const auto& desc = vertexDesc.pAttributeDescs[i];
-                                switch (desc.attributeType)
-                                {
-                                case VertexAttributeType::POSITION:
-                                {
-                                    DirectX::XMFLOAT3* pos = reinterpret_cast<DirectX::XMFLOAT3*>(curVertexByte + desc.attributeByteOffset);
-                                    *pos = newVertexPosition;
-                                }
-                                break;
-                                case VertexAttributeType::UV:
-                                {
-                                    DirectX::XMFLOAT2* uv = reinterpret_cast<DirectX::XMFLOAT2*>(curVertexByte + desc.attributeByteOffset);
-                                    *uv = {
-                                        DirectX::XMScalarACos(newVertexNormal.y) / DirectX::XM_PI,
-                                        0.5f + std::atan2f(newVertexNormal.x, newVertexNormal.z) / DirectX::XM_2PI,
-                                    };
-                                }
-                                break;
-                                case VertexAttributeType::NORMAL:
-                                {
-                                    DirectX::XMFLOAT3* normal = reinterpret_cast<DirectX::XMFLOAT3*>(curVertexByte + desc.attributeByteOffset);
-                                    *normal = newVertexNormal;
-                                }
-                                break;
-                                }
-                            }
-                        }
-                        newVertexIndices[edgeIndex] = newVertexIndex;
-                    }
+    void convertVertices(void* const dstVertices, const VertexDesc& dstDesc, const void* const srcVertices, const VertexDesc& srcDesc, const size_t vertexCount, const size_t threadCount)
+    {
+        PROFILE_ZONE("GeometryUtil::convertVertices");
 
-                    dstIndices[dstTriangleIndex++] = triangle[0];
-                    dstIndices[dstTriangleIndex++] = newVertexIndices[0];
-                    dstIndices[dstTriangleIndex++] = newVertexIndices[2];
-                    
-                    dstIndices[dstTriangleIndex++] = triangle[1];
-                    dstIndices[dstTriangleIndex++] = newVertexIndices[1];
-                    dstIndices[dstTriangleIndex++] = newVertexIndices[0];
-                    
-                    dstIndices[dstTriangleIndex++] = triangle[2];
-                    dstIndices[dstTriangleIndex++] = newVertexIndices[2];
-                    dstIndices[dstTriangleIndex++] = newVertexIndices[1];
-                    
-                    dstIndices[dstTriangleIndex++] = newVertexIndices[0];
-                    dstIndices[dstTriangleIndex++] = newVertexIndices[1];
-                    dstIndices[dstTriangleIndex++] = newVertexIndices[2];
-                }
+        AttributeConversion conversions[maxAttributeConversionCount];
+        size_t conversionCount = 0;
+        for (size_t i = 0; i < dstDesc.attributeCount; ++i)
+        {
+            const VertexAttributeDesc& dstAttributeDesc = dstDesc.pAttributeDescs[i];
+            if (dstAttributeDesc.attributeType == VertexAttributeType::UNINITIALIZED)
+            {
+                continue;
+            }
 
-                std::swap(dstVertices, srcVertices);
-                std::swap(dstIndices, srcIndices);
+            const VertexAttributeType srcAttributeType = getFloatAttributeType(dstAttributeDesc.attributeType);
+            const VertexAttributeDesc* const srcAttributeDescsEnd = srcDesc.pAttributeDescs + srcDesc.attributeCount;
+            const VertexAttributeDesc* const pSrcAttributeDesc = std::find_if(srcDesc.pAttributeDescs, srcAttributeDescsEnd,
+                [srcAttributeType](const VertexAttributeDesc& desc) { return desc.attributeType == srcAttributeType; });
+            assert(pSrcAttributeDesc != srcAttributeDescsEnd);
+            // layouts with an attribute type more than once only get the first maxAttributeConversionCount attributes
+            assert(conversionCount < maxAttributeConversionCount);
+            if (pSrcAttributeDesc != srcAttributeDescsEnd && conversionCount < maxAttributeConversionCount)
+            {
+                conversions[conversionCount++] = { dstAttributeDesc.attributeType, dstAttributeDesc.attributeByteOffset, pSrcAttributeDesc->attributeByteOffset };
             }
         }
-    }
 
-    void calculateVertexIndexCountsSquare(uint16_t vertexCountPerSide, size_t& vertexCount, size_t& indexCount)
-    {
-        vertexCount = vertexCountPerSide * vertexCountPerSide;
-        // square count is (vertexCountPerSide-1)^2 which becomes vertexCount^2 - 2*vertexCountPerSide + 1^2.
-        // triangle count is twice the square count, and index count is three times triangle count
-        indexCount = 6 * (vertexCount - 2 * vertexCountPerSide + 1);
-    }
+        uint8_t* const dstBytes = reinterpret_cast<uint8_t*>(dstVertices);
+        const uint8_t* const srcBytes = reinterpret_cast<const uint8_t*>(srcVertices);
+        const size_t dstStride = dstDesc.stride;
+        const size_t srcStride = srcDesc.stride;
 
-    void createSquare(const float width, const uint16_t vertexCountPerSide, void* const vertices, void* const indices, const VertexDesc& vertexDesc)
-    {
-        const float stepSize = width / (vertexCountPerSide - 1);
-        const float start = -width / 2.0f;
-        float x = start;
-        float y = x;
+        const DirectX::XMVECTOR boundsMin = DirectX::XMLoadFloat3(&dstDesc.positionBoundsMin);
+        const DirectX::XMVECTOR unorm16Scale = calculateUnorm16Scale(boundsMin, DirectX::XMLoadFloat3(&dstDesc.positionBoundsMax));
 
-        uint8_t* curVertexByte = reinterpret_cast<uint8_t*>(vertices);
-        for (size_t xOffset = 0; xOffset < vertexCountPerSide; ++xOffset)
+        // loads the float3 attributes of four vertices as x, y and z vectors, lanes past the end repeat the last vertex
+        const auto loadFloat3s = [&](const size_t first, const size_t end, const size_t srcByteOffset, DirectX::XMVECTOR& x, DirectX::XMVECTOR& y, DirectX::XMVECTOR& z)
         {
-            x = start;
-            for (size_t yOffset = 0; yOffset < vertexCountPerSide; ++yOffset)
+            DirectX::XMMATRIX attributes;
+            for (size_t lane = 0; lane < 4u; ++lane)
             {
-                for (size_t i = 0; i < vertexDesc.attributeCount; ++i)
+                const size_t vertexIndex = std::min(first + lane, end - 1u);
+                attributes.r[lane] = DirectX::XMLoadFloat3(reinterpret_cast<const DirectX::XMFLOAT3*>(srcBytes + vertexIndex * srcStride + srcByteOffset));
+            }
+            attributes = DirectX::XMMatrixTranspose(attributes);
+            x = attributes.r[0];
+            y = attributes.r[1];
+            z = attributes.r[2];
+        };
+
+        const auto convertBlock = [&](const size_t begin, const size_t end)
+        {
+            for (size_t conversionIndex = 0; conversionIndex < conversionCount; ++conversionIndex)
+            {
+                const AttributeConversion& conversion = conversions[conversionIndex];
+                uint8_t* const pDst = dstBytes + conversion.dstByteOffset;
+                const uint8_t* const pSrc = srcBytes + conversion.srcByteOffset;
+                switch (conversion.dstAttributeType)
                 {
-                    const auto& desc = vertexDesc.pAttributeDescs[i];
-                    switch (desc.attributeType)
+                case VertexAttributeType::POSITION:
+                case VertexAttributeType::NORMAL:
+                    for (size_t vertexIndex = begin; vertexIndex < end; ++vertexIndex)
                     {
-                    case VertexAttributeType::POSITION:
+                        std::memcpy(pDst + vertexIndex * dstStride, pSrc + vertexIndex * srcStride, sizeof(DirectX::XMFLOAT3));
+                    }
+                    break;
+                case VertexAttributeType::UV:
+                    for (size_t vertexIndex = begin; vertexIndex < end; ++vertexIndex)
                     {
-                        DirectX::XMFLOAT3* pos = reinterpret_cast<DirectX::XMFLOAT3*>(curVertexByte + desc.attributeByteOffset);
-                        *pos = { x, 0.0f, y };
+                        std::memcpy(pDst + vertexIndex * dstStride, pSrc + vertexIndex * srcStride, sizeof(DirectX::XMFLOAT2));
                     }
                     break;
-                    case VertexAttributeType::UV:
+                case VertexAttributeType::UV_HALF:
+                    for (size_t component = 0; component < 2u; ++component)
                     {
-                        DirectX::XMFLOAT2 *uv = reinterpret_cast<DirectX::XMFLOAT2*>(curVertexByte + desc.attributeByteOffset);
-                        *uv = {
-                            static_cast<float>(xOffset) / (vertexCountPerSide - 1),
-                            static_cast<float>(yOffset) / (vertexCountPerSide - 1)
-                        };
+                        DirectX::PackedVector::XMConvertFloatToHalfStream(
+                            reinterpret_cast<DirectX::PackedVector::HALF*>(pDst + begin * dstStride) + component, dstStride,
+                            reinterpret_cast<const float*>(pSrc + begin * srcStride) + component, srcStride, end - begin);
                     }
                     break;
-                    case VertexAttributeType::NORMAL:
+                case VertexAttributeType::NORMAL_OCT_SNORM16:
+                    for (size_t first = begin; first < end; first += 4u)
                     {
-                        DirectX::XMFLOAT3* normal = reinterpret_cast<DirectX::XMFLOAT3*>(curVertexByte + desc.attributeByteOffset);
-                        *normal = { 0.0f, 1.0f, 0.0f };
+                        DirectX::XMVECTOR x, y, z;
+                        loadFloat3s(first, end, conversion.srcByteOffset, x, y, z);
+                        DirectX::XMVECTORF32 encodedX;
+                        DirectX::XMVECTORF32 encodedY;
+                        encodeOctahedralNormals(x, y, z, encodedX.v, encodedY.v);
+                        for (size_t lane = 0; lane < std::min<size_t>(4u, end - first); ++lane)
+                        {
+                            int16_t* const pEncoded = reinterpret_cast<int16_t*>(pDst + (first + lane) * dstStride);
+                            pEncoded[0] = static_cast<int16_t>(encodedX.f[lane]);
+                            pEncoded[1] = static_cast<int16_t>(encodedY.f[lane]);
+                        }
                     }
                     break;
+                case VertexAttributeType::POSITION_UNORM16:
+                    for (size_t first = begin; first < end; first += 4u)
+                    {
+                        DirectX::XMVECTOR x, y, z;
+                        loadFloat3s(first, end, conversion.srcByteOffset, x, y, z);
+                        DirectX::XMVECTORF32 quantizedX;
+                        DirectX::XMVECTORF32 quantizedY;
+                        DirectX::XMVECTORF32 quantizedZ;
+                        quantizedX.v = quantizeUnorm16(x, DirectX::XMVectorSplatX(boundsMin), DirectX::XMVectorSplatX(unorm16Scale));
+                        quantizedY.v = quantizeUnorm16(y, DirectX::XMVectorSplatY(boundsMin), DirectX::XMVectorSplatY(unorm16Scale));
+                        quantizedZ.v = quantizeUnorm16(z, DirectX::XMVectorSplatZ(boundsMin), DirectX::XMVectorSplatZ(unorm16Scale));
+                        for (size_t lane = 0; lane < std::min<size_t>(4u, end - first); ++lane)
+                        {
+                            uint16_t* const pQuantized = reinterpret_cast<uint16_t*>(pDst + (first + lane) * dstStride);
+                            pQuantized[0] = static_cast<uint16_t>(quantizedX.f[lane]);
+                            pQuantized[1] = static_cast<uint16_t>(quantizedY.f[lane]);
+                            pQuantized[2] = static_cast<uint16_t>(quantizedZ.f[lane]);
+                            pQuantized[3] = 0u;
+                        }
                     }
+                    break;
+                case VertexAttributeType::UNINITIALIZED:
+                    break;
                 }
-                curVertexByte += vertexDesc.stride;
-                x += stepSize;
             }
-            y += stepSize;
-        }
+        };
 
-        uint16_t *curIndex = reinterpret_cast<uint16_t*>(indices);
-        for (uint16_t xOffset = 0; xOffset < vertexCountPerSide - 1; ++xOffset)
+        const size_t conversionThreadCount = ThreadUtil::getThreadCount(vertexCount, threadCount);
+        ThreadUtil::parallelFor(vertexCount, [&](const size_t begin, const size_t end)
         {
-            for (uint16_t yOffset = 0; yOffset < vertexCountPerSide - 1; ++yOffset)
+            for (size_t blockBegin = begin; blockBegin < end; blockBegin += conversionBlockSize)
             {
-                *(curIndex++) = yOffset * vertexCountPerSide + xOffset;
-                *(curIndex++) = yOffset * vertexCountPerSide + xOffset + 1;
-                *(curIndex++) = (yOffset + 1) * vertexCountPerSide + xOffset;
-
-                *(curIndex++) = (yOffset + 1) * vertexCountPerSide + xOffset;
-                *(curIndex++) = yOffset * vertexCountPerSide + xOffset + 1;
-                *(curIndex++) = (yOffset + 1) * vertexCountPerSide + xOffset + 1;
+                convertBlock(blockBegin, std::min(blockBegin + conversionBlockSize, end));
             }
+        }, conversionThreadCount);
+    }
+
+    Bounds calculateBounds(const void* const vertices, const VertexDesc& vertexDesc, const size_t vertexCount, const size_t threadCount)
+    {
+        PROFILE_ZONE("GeometryUtil::calculateBounds");
+
+        const uint8_t* const vertexBytes = reinterpret_cast<const uint8_t*>(vertices);
+        const size_t stride = vertexDesc.stride;
+        const VertexAttributeDesc* const attributeDescsEnd = vertexDesc.pAttributeDescs + vertexDesc.attributeCount;
+
+        const VertexAttributeDesc* const pPositionDesc = std::find_if(vertexDesc.pAttributeDescs, attributeDescsEnd,
+            [](const VertexAttributeDesc& desc) { return desc.attributeType == VertexAttributeType::POSITION; });
+        if (pPositionDesc != attributeDescsEnd)
+        {
+            const uint8_t* const pPositions = vertexBytes + pPositionDesc->attributeByteOffset;
+            return calculatePositionBounds(vertexCount, threadCount, [pPositions, stride](const size_t vertexIndex)
+            {
+                return DirectX::XMLoadFloat3(reinterpret_cast<const DirectX::XMFLOAT3*>(pPositions + vertexIndex * stride));
+            });
         }
+
+        const VertexAttributeDesc* const pQuantizedPositionDesc = std::find_if(vertexDesc.pAttributeDescs, attributeDescsEnd,
+            [](const VertexAttributeDesc& desc) { return desc.attributeType == VertexAttributeType::POSITION_UNORM16; });
+        assert(pQuantizedPositionDesc != attributeDescsEnd);
+        if (pQuantizedPositionDesc == attributeDescsEnd)
+        {
+            return {};
+        }
+
+        // quantized w is 0, so decoded positions keep a w of 0 as well
+        const uint8_t* const pPositions = vertexBytes + pQuantizedPositionDesc->attributeByteOffset;
+        const DirectX::XMVECTOR xmvBoundsMin = DirectX::XMLoadFloat3(&vertexDesc.positionBoundsMin);
+        const DirectX::XMVECTOR xmvStep = DirectX::XMVectorScale(DirectX::XMVectorSubtract(DirectX::XMLoadFloat3(&vertexDesc.positionBoundsMax), xmvBoundsMin), 1.0f / 65535.0f);
+        return calculatePositionBounds(vertexCount, threadCount, [pPositions, stride, xmvBoundsMin, xmvStep](const size_t vertexIndex)
+        {
+            const DirectX::XMVECTOR xmvQuantized = DirectX::PackedVector::XMLoadUShort4(reinterpret_cast<const DirectX::PackedVector::XMUSHORT4*>(pPositions + vertexIndex * stride));
+            return DirectX::XMVectorMultiplyAdd(xmvQuantized, xmvStep, xmvBoundsMin);
+        });
     }
 }
\ No newline at end of file
@@ -1,6 +1,22 @@
 #pragma once
 
+#include <cassert>
 #include <cinttypes>
+#include <cstddef>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "DirectXMath.h"
+#include "DirectXPackedVector.h"
+
+#include "ProfileUtil.h"
+#include "ThreadUtil.h"
 
 namespace GeometryUtil
 {
@@ -10,6 +26,10 @@ namespace GeometryUtil
         UV,
         NORMAL,
         UNINITIALIZED, // ignored during geometry generation, use to leave space for custom attribs
+        // compact encodings, the comments name the matching DXGI format
+        UV_HALF, // DXGI_FORMAT_R16G16_FLOAT
+        NORMAL_OCT_SNORM16, // octahedral encoding, see encodeOctahedralNormals, DXGI_FORMAT_R16G16_SNORM
+        POSITION_UNORM16, // relative to the position bounds of the VertexDesc, w is 0, DXGI_FORMAT_R16G16B16A16_UNORM
     };
 
     struct VertexAttributeDesc
@@ -23,21 +43,1168 @@ namespace GeometryUtil
         size_t attributeCount;
         const VertexAttributeDesc* pAttributeDescs;
         size_t stride;
+        // box POSITION_UNORM16 maps to [0, 1], positions outside of it are clamped to its faces
+        DirectX::XMFLOAT3 positionBoundsMin = { 0.0f, 0.0f, 0.0f };
+        DirectX::XMFLOAT3 positionBoundsMax = { 0.0f, 0.0f, 0.0f };
     };
 
-    constexpr VertexAttributeDesc defaultAttributeCollection[] =
+    inline constexpr VertexAttributeDesc defaultAttributeCollection[] =
     {
         {VertexAttributeType::POSITION, 0u},
         {VertexAttributeType::UV, 12u},
         {VertexAttributeType::NORMAL, 20u},
     };
 
-    constexpr VertexDesc defaultVertexDesc = {
+    inline constexpr VertexDesc defaultVertexDesc = {
         sizeof(defaultAttributeCollection) / sizeof(VertexAttributeDesc), defaultAttributeCollection, 32u
     };
 
-    void calculateVertexIndexCountsGeoSphere(uint8_t suddivisions, size_t& vertexCount, size_t& indexCount);
-    void createGeoSphere(const float radius, const uint8_t subdivisions, void* const vertices, void* const indices, const VertexDesc& = defaultVertexDesc);
-    void calculateVertexIndexCountsSquare(uint16_t vertexCountPerSide, size_t& vertexCount, size_t& indexCount);
-    void createSquare(const float width, const uint16_t vertexCountPerSide, void* const vertices, void* const indices, const VertexDesc& = defaultVertexDesc);
-}
\ No newline at end of file
+    // Same attributes as defaultVertexDesc in 20 instead of 32 bytes, with half float UVs and octahedral normals.
+    inline constexpr VertexAttributeDesc compactAttributeCollection[] =
+    {
+        {VertexAttributeType::POSITION, 0u},
+        {VertexAttributeType::UV_HALF, 12u},
+        {VertexAttributeType::NORMAL_OCT_SNORM16, 16u},
+    };
+
+    inline constexpr VertexDesc compactVertexDesc = {
+        sizeof(compactAttributeCollection) / sizeof(VertexAttributeDesc), compactAttributeCollection, 20u
+    };
+
+    // Octahedral normal encoding projects the unit sphere onto the octahedron |x| + |y| + |z| = 1 and folds its lower
+    // half over the upper one, leaving two coordinates in [-1, 1]. The shader decodes (x, y) with
+    // n = (x, y, 1 - |x| - |y|), n.xy -= (n.xy >= 0 ? 1 : -1) * saturate(-n.z) and normalizes n.
+    // Encodes four normals given as SoA vectors, the results are the SNORM16 values as floats.
+    inline void XM_CALLCONV encodeOctahedralNormals(DirectX::FXMVECTOR x, DirectX::FXMVECTOR y, DirectX::FXMVECTOR z, DirectX::XMVECTOR& encodedX, DirectX::XMVECTOR& encodedY)
+    {
+        const DirectX::XMVECTOR zero = DirectX::XMVectorZero();
+        const DirectX::XMVECTOR one = DirectX::XMVectorSplatOne();
+        const DirectX::XMVECTOR minusOne = DirectX::XMVectorNegate(one);
+
+        const DirectX::XMVECTOR absSum = DirectX::XMVectorAdd(DirectX::XMVectorAdd(DirectX::XMVectorAbs(x), DirectX::XMVectorAbs(y)), DirectX::XMVectorAbs(z));
+        const DirectX::XMVECTOR octX = DirectX::XMVectorDivide(x, absSum);
+        const DirectX::XMVECTOR octY = DirectX::XMVectorDivide(y, absSum);
+
+        const DirectX::XMVECTOR signX = DirectX::XMVectorSelect(minusOne, one, DirectX::XMVectorGreaterOrEqual(octX, zero));
+        const DirectX::XMVECTOR signY = DirectX::XMVectorSelect(minusOne, one, DirectX::XMVectorGreaterOrEqual(octY, zero));
+        const DirectX::XMVECTOR foldedX = DirectX::XMVectorMultiply(DirectX::XMVectorSubtract(one, DirectX::XMVectorAbs(octY)), signX);
+        const DirectX::XMVECTOR foldedY = DirectX::XMVectorMultiply(DirectX::XMVectorSubtract(one, DirectX::XMVectorAbs(octX)), signY);
+        const DirectX::XMVECTOR lowerHalf = DirectX::XMVectorLess(z, zero);
+
+        const DirectX::XMVECTOR snormScale = DirectX::XMVectorReplicate(32767.0f);
+        encodedX = DirectX::XMVectorSelect(octX, foldedX, lowerHalf);
+        encodedX = DirectX::XMVectorRound(DirectX::XMVectorMultiply(DirectX::XMVectorClamp(encodedX, minusOne, one), snormScale));
+        encodedY = DirectX::XMVectorSelect(octY, foldedY, lowerHalf);
+        encodedY = DirectX::XMVectorRound(DirectX::XMVectorMultiply(DirectX::XMVectorClamp(encodedY, minusOne, one), snormScale));
+    }
+
+    // scale that maps the position bounds of a VertexDesc to [0, 65535], flat axes map to 0
+    inline DirectX::XMVECTOR XM_CALLCONV calculateUnorm16Scale(DirectX::FXMVECTOR boundsMin, DirectX::FXMVECTOR boundsMax)
+    {
+        const DirectX::XMVECTOR extent = DirectX::XMVectorSubtract(boundsMax, boundsMin);
+        const DirectX::XMVECTOR scale = DirectX::XMVectorDivide(DirectX::XMVectorReplicate(65535.0f), extent);
+        return DirectX::XMVectorSelect(DirectX::XMVectorZero(), scale, DirectX::XMVectorGreater(extent, DirectX::XMVectorZero()));
+    }
+
+    // UNORM16 values as floats, works on positions as well as on SoA vectors of one coordinate
+    inline DirectX::XMVECTOR XM_CALLCONV quantizeUnorm16(DirectX::FXMVECTOR value, DirectX::FXMVECTOR boundsMin, DirectX::FXMVECTOR scale)
+    {
+        const DirectX::XMVECTOR quantized = DirectX::XMVectorMultiply(DirectX::XMVectorSubtract(value, boundsMin), scale);
+        return DirectX::XMVectorRound(DirectX::XMVectorClamp(quantized, DirectX::XMVectorZero(), DirectX::XMVectorReplicate(65535.0f)));
+    }
+
+    // all attributes the generators can produce for one vertex, vertex writers pick the ones their layout contains
+    struct VertexData
+    {
+        DirectX::XMFLOAT3 position;
+        DirectX::XMFLOAT2 uv;
+        DirectX::XMFLOAT3 normal;
+    };
+
+    // Axis aligned box and bounding sphere of a mesh in its own space, for culling. Both enclose every vertex.
+    struct Bounds
+    {
+        DirectX::XMFLOAT3 aabbMin;
+        DirectX::XMFLOAT3 aabbMax;
+        DirectX::XMFLOAT3 sphereCenter;
+        float sphereRadius;
+    };
+
+    // constexpr stand-in for std::sqrt, computed in double precision
+    constexpr double constexprSqrt(const double x)
+    {
+        if (x <= 0.0)
+        {
+            return 0.0;
+        }
+
+        // Newton's method approaches the root from above, it has converged once the estimate stops shrinking
+        double root = x > 1.0 ? x : 1.0;
+        while (true)
+        {
+            const double nextRoot = 0.5 * (root + x / root);
+            if (nextRoot >= root)
+            {
+                return root;
+            }
+            root = nextRoot;
+        }
+    }
+
+    // bounds of meshes whose farthest vertices from the box center are corners of the box, like squares
+    constexpr Bounds calculateBoxBounds(const DirectX::XMFLOAT3& aabbMin, const DirectX::XMFLOAT3& aabbMax)
+    {
+        const DirectX::XMFLOAT3 center = { 0.5f * (aabbMin.x + aabbMax.x), 0.5f * (aabbMin.y + aabbMax.y), 0.5f * (aabbMin.z + aabbMax.z) };
+        const double extentX = std::max(aabbMax.x - center.x, center.x - aabbMin.x);
+        const double extentY = std::max(aabbMax.y - center.y, center.y - aabbMin.y);
+        const double extentZ = std::max(aabbMax.z - center.z, center.z - aabbMin.z);
+        return { aabbMin, aabbMax, center, static_cast<float>(constexprSqrt(extentX * extentX + extentY * extentY + extentZ * extentZ)) };
+    }
+
+    template <VertexAttributeType attributeType>
+    inline void writeVertexAttribute(uint8_t* const pAttribute, const VertexData& vertexData, const VertexDesc& vertexDesc)
+    {
+        if constexpr (attributeType == VertexAttributeType::POSITION)
+        {
+            *reinterpret_cast<DirectX::XMFLOAT3*>(pAttribute) = vertexData.position;
+        }
+        else if constexpr (attributeType == VertexAttributeType::UV)
+        {
+            *reinterpret_cast<DirectX::XMFLOAT2*>(pAttribute) = vertexData.uv;
+        }
+        else if constexpr (attributeType == VertexAttributeType::NORMAL)
+        {
+            *reinterpret_cast<DirectX::XMFLOAT3*>(pAttribute) = vertexData.normal;
+        }
+        else if constexpr (attributeType == VertexAttributeType::UV_HALF)
+        {
+            *reinterpret_cast<DirectX::PackedVector::XMHALF2*>(pAttribute) = DirectX::PackedVector::XMHALF2(vertexData.uv.x, vertexData.uv.y);
+        }
+        else if constexpr (attributeType == VertexAttributeType::NORMAL_OCT_SNORM16)
+        {
+            DirectX::XMVECTOR encodedX;
+            DirectX::XMVECTOR encodedY;
+            encodeOctahedralNormals(DirectX::XMVectorReplicate(vertexData.normal.x), DirectX::XMVectorReplicate(vertexData.normal.y),
+                DirectX::XMVectorReplicate(vertexData.normal.z), encodedX, encodedY);
+            int16_t* const pEncoded = reinterpret_cast<int16_t*>(pAttribute);
+            pEncoded[0] = static_cast<int16_t>(DirectX::XMVectorGetX(encodedX));
+            pEncoded[1] = static_cast<int16_t>(DirectX::XMVectorGetX(encodedY));
+        }
+        else if constexpr (attributeType == VertexAttributeType::POSITION_UNORM16)
+        {
+            const DirectX::XMVECTOR boundsMin = DirectX::XMLoadFloat3(&vertexDesc.positionBoundsMin);
+            const DirectX::XMVECTOR scale = calculateUnorm16Scale(boundsMin, DirectX::XMLoadFloat3(&vertexDesc.positionBoundsMax));
+            DirectX::XMVECTORF32 quantized;
+            quantized.v = quantizeUnorm16(DirectX::XMLoadFloat3(&vertexData.position), boundsMin, scale);
+            uint16_t* const pQuantized = reinterpret_cast<uint16_t*>(pAttribute);
+            pQuantized[0] = static_cast<uint16_t>(quantized.f[0]);
+            pQuantized[1] = static_cast<uint16_t>(quantized.f[1]);
+            pQuantized[2] = static_cast<uint16_t>(quantized.f[2]);
+            pQuantized[3] = 0u;
+        }
+        else
+        {
+            // UNINITIALIZED attributes are left untouched
+            (void)pAttribute;
+            (void)vertexData;
+        }
+        (void)vertexDesc;
+    }
+
+    constexpr size_t findAttributeByteOffset(const VertexDesc& vertexDesc, const VertexAttributeType attributeType)
+    {
+        for (size_t i = 0; i < vertexDesc.attributeCount; ++i)
+        {
+            if (vertexDesc.pAttributeDescs[i].attributeType == attributeType)
+            {
+                return vertexDesc.pAttributeDescs[i].attributeByteOffset;
+            }
+        }
+        return 0u;
+    }
+
+    // Writes vertices in a layout that is only known at runtime by looping over the attribute descs of every vertex.
+    class RuntimeVertexWriter
+    {
+    public:
+        explicit RuntimeVertexWriter(const VertexDesc& vertexDesc) : m_vertexDesc(vertexDesc) {}
+
+        size_t getStride() const { return m_vertexDesc.stride; }
+        size_t getPositionByteOffset() const { return findAttributeByteOffset(m_vertexDesc, VertexAttributeType::POSITION); }
+        void finishWrites() const {}
+        void write(uint8_t* const pVertex, const VertexData& vertexData) const
+        {
+            for (size_t i = 0; i < m_vertexDesc.attributeCount; ++i)
+            {
+                const auto& desc = m_vertexDesc.pAttributeDescs[i];
+                switch (desc.attributeType)
+                {
+                case VertexAttributeType::POSITION:
+                    writeVertexAttribute<VertexAttributeType::POSITION>(pVertex + desc.attributeByteOffset, vertexData, m_vertexDesc);
+                    break;
+                case VertexAttributeType::UV:
+                    writeVertexAttribute<VertexAttributeType::UV>(pVertex + desc.attributeByteOffset, vertexData, m_vertexDesc);
+                    break;
+                case VertexAttributeType::NORMAL:
+                    writeVertexAttribute<VertexAttributeType::NORMAL>(pVertex + desc.attributeByteOffset, vertexData, m_vertexDesc);
+                    break;
+                case VertexAttributeType::UV_HALF:
+                    writeVertexAttribute<VertexAttributeType::UV_HALF>(pVertex + desc.attributeByteOffset, vertexData, m_vertexDesc);
+                    break;
+                case VertexAttributeType::NORMAL_OCT_SNORM16:
+                    writeVertexAttribute<VertexAttributeType::NORMAL_OCT_SNORM16>(pVertex + desc.attributeByteOffset, vertexData, m_vertexDesc);
+                    break;
+                case VertexAttributeType::POSITION_UNORM16:
+                    writeVertexAttribute<VertexAttributeType::POSITION_UNORM16>(pVertex + desc.attributeByteOffset, vertexData, m_vertexDesc);
+                    break;
+                case VertexAttributeType::UNINITIALIZED:
+                    break;
+                }
+            }
+        }
+    private:
+        const VertexDesc& m_vertexDesc;
+    };
+
+    // Writes vertices in a layout that is known at compile time. The attribute loop is unrolled and every attribute
+    // becomes a plain store at a constant offset, e.g. StaticVertexWriter<defaultVertexDesc>. The desc has to be a
+    // constexpr object with static storage duration.
+    template <const VertexDesc& vertexDesc>
+    class StaticVertexWriter
+    {
+    public:
+        static constexpr size_t getStride() { return vertexDesc.stride; }
+        static constexpr size_t getPositionByteOffset() { return findAttributeByteOffset(vertexDesc, VertexAttributeType::POSITION); }
+        static void finishWrites() {}
+        static void write(uint8_t* const pVertex, const VertexData& vertexData)
+        {
+            writeAttributes(pVertex, vertexData, std::make_index_sequence<vertexDesc.attributeCount>());
+        }
+    private:
+        template <size_t... attributeIndices>
+        static void writeAttributes(uint8_t* const pVertex, const VertexData& vertexData, std::index_sequence<attributeIndices...>)
+        {
+            (writeVertexAttribute<vertexDesc.pAttributeDescs[attributeIndices].attributeType>(
+                pVertex + vertexDesc.pAttributeDescs[attributeIndices].attributeByteOffset, vertexData, vertexDesc), ...);
+        }
+    };
+
+    // the stride of vertex writers that know their layout at compile time, 0 for runtime layouts
+    template <typename VertexWriter>
+    constexpr size_t staticVertexStride = 0u;
+    template <const VertexDesc& vertexDesc>
+    constexpr size_t staticVertexStride<StaticVertexWriter<vertexDesc>> = vertexDesc.stride;
+
+    // float POSITION, UV and NORMAL back to back in 32 bytes like defaultVertexDesc, two vectors per vertex
+    constexpr bool isPackedFloatVertexDesc(const VertexDesc& vertexDesc)
+    {
+        if (vertexDesc.stride != 32u || vertexDesc.attributeCount != 3u)
+        {
+            return false;
+        }
+        for (size_t i = 0; i < vertexDesc.attributeCount; ++i)
+        {
+            const VertexAttributeDesc& desc = vertexDesc.pAttributeDescs[i];
+            const size_t expectedByteOffset = desc.attributeType == VertexAttributeType::POSITION ? 0u :
+                desc.attributeType == VertexAttributeType::UV ? 12u : desc.attributeType == VertexAttributeType::NORMAL ? 20u : 1u;
+            if (desc.attributeByteOffset != expectedByteOffset)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // vertex writers whose vertices generators may store as whole vectors, several vertices at a time
+    template <typename VertexWriter>
+    constexpr bool isPackedFloatVertexWriter = false;
+    template <const VertexDesc& vertexDesc>
+    constexpr bool isPackedFloatVertexWriter<StaticVertexWriter<vertexDesc>> = isPackedFloatVertexDesc(vertexDesc);
+
+    // Wraps another vertex writer for memory that should only ever be written, such as mapped upload heaps, which are
+    // usually write-combined. Every vertex is assembled on the stack and stored in one go, with non-temporal stores if
+    // the vertex is 16 byte aligned and its stride a multiple of 16, so full lines reach memory without being read into
+    // the cache. UNINITIALIZED attributes and padding are written as zeros. Compile time layouts have to fit into
+    // maxStride, runtime layouts that do not are written straight through the wrapped writer, which leaves them
+    // untouched.
+    template <typename VertexWriter>
+    class WriteCombinedVertexWriter
+    {
+    public:
+        static constexpr size_t maxStride = 256u;
+        static_assert(staticVertexStride<VertexWriter> <= maxStride, "the vertex layout does not fit the staging buffer");
+
+        explicit WriteCombinedVertexWriter(const VertexWriter& vertexWriter = VertexWriter()) : m_vertexWriter(vertexWriter) {}
+
+        size_t getStride() const { return m_vertexWriter.getStride(); }
+        size_t getPositionByteOffset() const { return m_vertexWriter.getPositionByteOffset(); }
+        // non-temporal stores are weakly ordered, generators call this on every thread that wrote vertices
+        void finishWrites() const { XM_SFENCE(); }
+        void write(uint8_t* const pVertex, const VertexData& vertexData) const
+        {
+            const size_t stride = m_vertexWriter.getStride();
+            if (stride > maxStride)
+            {
+                m_vertexWriter.write(pVertex, vertexData);
+                return;
+            }
+
+            // the wrapped writer skips UNINITIALIZED attributes and padding, which must not stream stack contents.
+            // Generators share the writer between threads, so the buffer cannot be a member that is cleared once.
+            alignas(16) uint8_t vertex[maxStride];
+            std::memset(vertex, 0, stride);
+            m_vertexWriter.write(vertex, vertexData);
+            if (((reinterpret_cast<uintptr_t>(pVertex) | stride) & 15u) == 0u)
+            {
+                for (size_t byteOffset = 0; byteOffset < stride; byteOffset += 16u)
+                {
+                    const DirectX::XMVECTOR xmvBytes = DirectX::XMLoadFloat4A(reinterpret_cast<const DirectX::XMFLOAT4A*>(vertex + byteOffset));
+                    XM_STREAM_PS(reinterpret_cast<float*>(pVertex + byteOffset), xmvBytes);
+                }
+            }
+            else
+            {
+                std::memcpy(pVertex, vertex, stride);
+            }
+        }
+    private:
+        VertexWriter m_vertexWriter;
+    };
+
+    // Generators are templated on the index type, which has to be uint16_t or uint32_t. 16 bit indices can address
+    // geospheres with up to 6 subdivisions and squares with up to 256 vertices per side. Large meshes are generated
+    // on multiple threads, a threadCount of 0 picks the thread count from the mesh size. Generators never read
+    // vertices or indices back, so together with a WriteCombinedVertexWriter, which stores every vertex whole, they
+    // can write straight into mapped upload heaps. Threads do not walk their memory in address order though, the
+    // geosphere writes the vertices and indices of every face level by level. Generators return the Bounds of the
+    // vertices they wrote, which are collected while generating for the same reason.
+    template <typename IndexType>
+    constexpr bool canIndexVertexCount(const size_t vertexCount)
+    {
+        static_assert(std::is_same_v<IndexType, uint16_t> || std::is_same_v<IndexType, uint32_t>, "indices need to be uint16_t or uint32_t");
+        return vertexCount == 0u || vertexCount - 1u <= std::numeric_limits<IndexType>::max();
+    }
+
+    constexpr void calculateVertexIndexCountsGeoSphere(const uint8_t subdivisions, size_t& vertexCount, size_t& indexCount)
+    {
+        /*
+        // Base icosahedron has 12 vertices, 20 triangles and 30 edges. Each subdivision replaces one triangle by
+        // 4 triangles (think triforce) and splits the edges in two halfs, adding one vertex per edge and 3 edges
+        // inside of each triangle.
+        vertexCount = 12;
+        size_t edgeCount = 30;
+        size_t triangleCount = 20;
+        for (uint8_t i = 0; i < subdivisions; ++i)
+        {
+            vertexCount += edgeCount;
+            edgeCount = 2*edgeCount + 3*triangleCount;
+            triangleCount *= 4;
+        }
+        // Each vertex is part of 5 triangles
+        indexCount = 5*vertexCount;
+        */
+        // solved recurrence relation, vertex count is 2 + 10*4^(subdivisions)
+        // 4^x = 1 << (x*2)
+        const size_t powerOfFour = static_cast<size_t>(1u) << (subdivisions * 2);
+        vertexCount = 2 + 10 * powerOfFour;
+        indexCount = 3 * 20 * powerOfFour;
+    }
+
+    template <typename IndexType>
+    Bounds createGeoSphere(const float radius, const uint8_t subdivisions, void* const vertices, IndexType* const indices, const VertexDesc& = defaultVertexDesc);
+    // A geosphere LOD chain holds the index lists of subdivisions 0 to maxSubdivisions back to back, coarsest first.
+    // Every level's vertices are a prefix of the next level's, so all levels index into the vertex buffer of the
+    // finest one and lods[level] describes the range a level draws. lods needs maxSubdivisions + 1 entries.
+    struct GeoSphereLod
+    {
+        size_t startIndex;
+        size_t indexCount;
+        size_t vertexCount;
+    };
+    constexpr void calculateVertexIndexCountsGeoSphereLodChain(const uint8_t maxSubdivisions, size_t& vertexCount, size_t& indexCount)
+    {
+        // the finest level's vertices, and 60 * (4^0 + ... + 4^maxSubdivisions) = 20 * (4^(maxSubdivisions+1) - 1) indices
+        size_t finestIndexCount = 0;
+        calculateVertexIndexCountsGeoSphere(maxSubdivisions, vertexCount, finestIndexCount);
+        const size_t powerOfFour = static_cast<size_t>(1u) << ((maxSubdivisions + 1) * 2);
+        indexCount = 20 * (powerOfFour - 1);
+    }
+
+    template <typename IndexType>
+    Bounds createGeoSphereLodChain(const float radius, const uint8_t maxSubdivisions, void* const vertices, IndexType* const indices, GeoSphereLod* const lods, const VertexDesc& = defaultVertexDesc);
+    constexpr void calculateVertexIndexCountsSquare(const uint32_t vertexCountPerSide, size_t& vertexCount, size_t& indexCount)
+    {
+        vertexCount = static_cast<size_t>(vertexCountPerSide) * vertexCountPerSide;
+        // square count is (vertexCountPerSide-1)^2 which becomes vertexCount^2 - 2*vertexCountPerSide + 1^2.
+        // triangle count is twice the square count, and index count is three times triangle count
+        indexCount = 6 * (vertexCount - 2 * vertexCountPerSide + 1);
+    }
+
+    template <typename IndexType>
+    Bounds createSquare(const float width, const uint32_t vertexCountPerSide, void* const vertices, IndexType* const indices, const VertexDesc& = defaultVertexDesc);
+
+    // Re-encodes float vertices into another layout, e.g. defaultVertexDesc vertices into compactVertexDesc ones.
+    // Every attribute of dstDesc other than UNINITIALIZED needs a float POSITION, UV or NORMAL counterpart in srcDesc.
+    // Works on four vertices at a time with SIMD, a threadCount of 0 picks the thread count from the vertex count.
+    void convertVertices(void* const dstVertices, const VertexDesc& dstDesc, const void* const srcVertices, const VertexDesc& srcDesc, const size_t vertexCount, const size_t threadCount = 0u);
+
+    // Bounds of vertices in any layout with a POSITION or POSITION_UNORM16 attribute, for meshes that were not made by
+    // a generator or change after generation. The box is exact and the sphere is centered on it. One SIMD pass finds
+    // the box and a second one the radius, cheap enough to run every frame on dynamic meshes. A threadCount of 0 picks
+    // the thread count from the vertex count.
+    Bounds calculateBounds(const void* const vertices, const VertexDesc& vertexDesc, const size_t vertexCount, const size_t threadCount = 0u);
+
+    // triangles of the icosahedron all geospheres start from
+    inline constexpr uint8_t geoSphereBaseIndices[] = {
+        0, 5, 4,
+        0, 9, 5,
+        1, 9, 0,
+        1, 7, 9,
+        1, 6, 7,
+        1, 8, 6,
+        1, 0, 8,
+        0, 4, 8,
+        5, 9, 11,
+        7, 11, 9,
+        4, 10, 8,
+        6, 8, 10,
+        2, 4, 5,
+        2, 5, 11,
+        2, 11, 3,
+        3, 11, 7,
+        3, 7, 6,
+        3, 6, 10,
+        2, 3, 10,
+        2, 10, 4,
+    };
+
+    // Point on the triangular grid a geosphere face is split into. With n = 2^subdivisions segments per base edge,
+    // (i, j) lies at v0 + i/n * (v1 - v0) + j/n * (v2 - v0) before being pushed out onto the sphere.
+    struct GeoSphereGridPoint
+    {
+        int32_t i;
+        int32_t j;
+    };
+
+    // visits the triangles 'depth' subdivisions below (a, b, c) in the order subdivision creates them, which is
+    // (a, ab, ca), (b, bc, ab), (c, ca, bc), (ab, bc, ca) for every split triangle
+    template <typename Visitor>
+    void visitGeoSphereTriangles(const GeoSphereGridPoint& a, const GeoSphereGridPoint& b, const GeoSphereGridPoint& c, const uint8_t depth, Visitor& visitor)
+    {
+        if (depth == 0u)
+        {
+            visitor(a, b, c);
+            return;
+        }
+
+        const GeoSphereGridPoint ab = { (a.i + b.i) / 2, (a.j + b.j) / 2 };
+        const GeoSphereGridPoint bc = { (b.i + c.i) / 2, (b.j + c.j) / 2 };
+        const GeoSphereGridPoint ca = { (c.i + a.i) / 2, (c.j + a.j) / 2 };
+        const uint8_t childDepth = static_cast<uint8_t>(depth - 1u);
+        visitGeoSphereTriangles(a, ab, ca, childDepth, visitor);
+        visitGeoSphereTriangles(b, bc, ab, childDepth, visitor);
+        visitGeoSphereTriangles(c, ca, bc, childDepth, visitor);
+        visitGeoSphereTriangles(ab, bc, ca, childDepth, visitor);
+    }
+
+    // Writes the vertices of a geosphere with 'subdivisions' subdivisions and, back to back, the index lists of every
+    // level from minSubdivisions up to subdivisions, coarsest first. A level only references vertices of the levels
+    // before it, so all of them share the vertex buffer of the finest level.
+    template <typename IndexType, typename VertexWriter>
+    Bounds createGeoSphereLevels(const float radius, const uint8_t minSubdivisions, const uint8_t subdivisions, void* const vertices, IndexType* const indices, const VertexWriter& vertexWriter, const size_t threadCount = 0u)
+    {
+        PROFILE_ZONE("GeometryUtil::createGeoSphere");
+        assert(minSubdivisions <= subdivisions);
+        size_t vertexCount;
+        size_t indexCount;
+        calculateVertexIndexCountsGeoSphere(subdivisions, vertexCount, indexCount);
+        assert(canIndexVertexCount<IndexType>(vertexCount));
+
+        const float phi = 1.6180339887f;
+        const float distFromCenter = std::sqrt(phi * phi + 1.0f);
+        const float normalizationFactor = radius / distFromCenter;
+        const float phiNorm = phi * normalizationFactor;
+        const float oneNorm = normalizationFactor;
+
+        const DirectX::XMFLOAT3 baseVertexPositions[] = {
+            {0.0f,  phiNorm,  oneNorm},
+            {0.0f,  phiNorm, -oneNorm},
+            {0.0f, -phiNorm,  oneNorm},
+            {0.0f, -phiNorm, -oneNorm},
+            {-oneNorm, 0.0f,  phiNorm},
+            { oneNorm, 0.0f,  phiNorm},
+            {-oneNorm, 0.0f, -phiNorm},
+            { oneNorm, 0.0f, -phiNorm},
+            {-phiNorm,  oneNorm, 0.0f},
+            { phiNorm,  oneNorm, 0.0f},
+            {-phiNorm, -oneNorm, 0.0f},
+            { phiNorm, -oneNorm, 0.0f},
+        };
+
+        const size_t stride = vertexWriter.getStride();
+        uint8_t* const vertexBytes = reinterpret_cast<uint8_t*>(vertices);
+
+        // the box is grown with every written vertex, the sphere is centered on the origin and reaches the farthest one
+        const DirectX::XMVECTOR xmvEmptyMin = DirectX::XMVectorReplicate(std::numeric_limits<float>::max());
+        const DirectX::XMVECTOR xmvEmptyMax = DirectX::XMVectorReplicate(-std::numeric_limits<float>::max());
+        DirectX::XMVECTOR xmvBoundsMin = xmvEmptyMin;
+        DirectX::XMVECTOR xmvBoundsMax = xmvEmptyMax;
+        DirectX::XMVECTOR xmvMaxLengthSq = DirectX::XMVectorZero();
+
+        for (size_t baseVertexId = 0; baseVertexId < 12u; ++baseVertexId)
+        {
+            const DirectX::XMVECTOR xmvPosition = DirectX::XMLoadFloat3(&baseVertexPositions[baseVertexId]);
+            xmvBoundsMin = DirectX::XMVectorMin(xmvBoundsMin, xmvPosition);
+            xmvBoundsMax = DirectX::XMVectorMax(xmvBoundsMax, xmvPosition);
+            xmvMaxLengthSq = DirectX::XMVectorMax(xmvMaxLengthSq, DirectX::XMVector3LengthSq(xmvPosition));
+
+            VertexData vertexData;
+            vertexData.position = baseVertexPositions[baseVertexId];
+            vertexData.normal = baseVertexPositions[baseVertexId];
+            vertexData.normal.x *= 1.0f / radius;
+            vertexData.normal.y *= 1.0f / radius;
+            vertexData.normal.z *= 1.0f / radius;
+            vertexData.uv = {
+                DirectX::XMScalarACos(vertexData.normal.y) / DirectX::XM_PI,
+                0.5f + std::atan2(vertexData.normal.x, vertexData.normal.z) / DirectX::XM_2PI,
+            };
+            vertexWriter.write(vertexBytes + baseVertexId * stride, vertexData);
+        }
+        vertexWriter.finishWrites();
+
+        constexpr size_t faceCount = 20u;
+
+        // Subdividing level by level numbers the new vertices of a level in the order the triangles of the previous
+        // level reach their edges (ab, bc, ca). Faces are contiguous in that triangle order, so every face owns one
+        // contiguous block of new vertices per level, and an edge shared by two faces belongs to the block of the
+        // lower face index. This lets the faces be generated independently while keeping that layout, including
+        // every level's vertices being a prefix of the next level's.
+        struct EdgeOwnership
+        {
+            uint8_t owners[faceCount][3];
+            uint8_t ownedEdgeCounts[faceCount];
+        };
+        constexpr EdgeOwnership edgeOwnership = []()
+        {
+            EdgeOwnership result = {};
+            for (size_t faceIndex = 0; faceIndex < faceCount; ++faceIndex)
+            {
+                for (size_t edgeIndex = 0; edgeIndex < 3u; ++edgeIndex)
+                {
+                    const uint8_t v0 = geoSphereBaseIndices[faceIndex * 3 + edgeIndex];
+                    const uint8_t v1 = geoSphereBaseIndices[faceIndex * 3 + (edgeIndex + 1) % 3];
+                    size_t owner = 0;
+                    for (; owner < faceIndex; ++owner)
+                    {
+                        size_t sharedVertexCount = 0;
+                        for (size_t cornerIndex = 0; cornerIndex < 3u; ++cornerIndex)
+                        {
+                            const uint8_t corner = geoSphereBaseIndices[owner * 3 + cornerIndex];
+                            sharedVertexCount += (corner == v0 || corner == v1) ? 1u : 0u;
+                        }
+                        if (sharedVertexCount == 2u)
+                        {
+                            break;
+                        }
+                    }
+                    result.owners[faceIndex][edgeIndex] = static_cast<uint8_t>(owner);
+                    if (owner == faceIndex)
+                    {
+                        ++result.ownedEdgeCounts[faceIndex];
+                    }
+                }
+            }
+            return result;
+        }();
+
+        // each face is a triangular grid with n segments per edge, see GeoSphereGridPoint
+        const int32_t n = 1 << subdivisions;
+        const GeoSphereGridPoint corners[3] = { {0, 0}, {n, 0}, {0, n} };
+        const size_t gridPointCount = static_cast<size_t>(n + 1) * static_cast<size_t>(n + 2) / 2u;
+        const auto gridPointIndex = [n](const GeoSphereGridPoint& point)
+        {
+            // rows of constant j get shorter by one point each
+            const size_t j = static_cast<size_t>(point.j);
+            return j * (2u * static_cast<size_t>(n) + 3u - j) / 2u + static_cast<size_t>(point.i);
+        };
+
+        // vertex counts never reach the maximum index value, so it can mark grid points without an index
+        constexpr IndexType unassignedIndex = std::numeric_limits<IndexType>::max();
+        const std::unique_ptr<IndexType[]> gridIndicesPerFace = std::make_unique<IndexType[]>(faceCount * gridPointCount);
+        // positions of the grid points created so far, new vertices are placed between two of them
+        const std::unique_ptr<DirectX::XMFLOAT3[]> gridPositionsPerFace = std::make_unique<DirectX::XMFLOAT3[]>(faceCount * gridPointCount);
+
+        // bounds of the vertices each face wrote, merged once all faces are done
+        DirectX::XMFLOAT3 faceBoundsMin[faceCount];
+        DirectX::XMFLOAT3 faceBoundsMax[faceCount];
+        float faceMaxLengthSq[faceCount];
+
+        const auto generateFaceVertices = [&](const size_t faceIndex)
+        {
+            IndexType* const gridIndices = &gridIndicesPerFace[faceIndex * gridPointCount];
+            DirectX::XMFLOAT3* const gridPositions = &gridPositionsPerFace[faceIndex * gridPointCount];
+            std::fill(gridIndices, gridIndices + gridPointCount, unassignedIndex);
+
+            DirectX::XMVECTOR xmvFaceMin = xmvEmptyMin;
+            DirectX::XMVECTOR xmvFaceMax = xmvEmptyMax;
+            DirectX::XMVECTOR xmvFaceMaxLengthSq = DirectX::XMVectorZero();
+
+            for (size_t cornerIndex = 0; cornerIndex < 3u; ++cornerIndex)
+            {
+                const uint8_t baseIndex = geoSphereBaseIndices[faceIndex * 3 + cornerIndex];
+                gridIndices[gridPointIndex(corners[cornerIndex])] = baseIndex;
+                gridPositions[gridPointIndex(corners[cornerIndex])] = baseVertexPositions[baseIndex];
+            }
+
+            for (uint8_t level = 1u; level <= subdivisions; ++level)
+            {
+                // level l splits each of the m = 2^(l-1) segments of the base edges, and adds 3m(m-1)/2 vertices on
+                // the inner edges of a face
+                const size_t m = static_cast<size_t>(1u) << (level - 1);
+                size_t nextVertexIndex = 2u + 10u * m * m;
+                for (size_t previousFaceIndex = 0; previousFaceIndex < faceIndex; ++previousFaceIndex)
+                {
+                    nextVertexIndex += 3u * m * (m - 1u) / 2u + m * edgeOwnership.ownedEdgeCounts[previousFaceIndex];
+                }
+
+                auto splitEdges = [&](const GeoSphereGridPoint& a, const GeoSphereGridPoint& b, const GeoSphereGridPoint& c)
+                {
+                    const GeoSphereGridPoint triangle[] = { a, b, c };
+                    for (size_t edgeIndex = 0; edgeIndex < 3u; ++edgeIndex)
+                    {
+                        const GeoSphereGridPoint& p0 = triangle[edgeIndex];
+                        const GeoSphereGridPoint& p1 = triangle[(edgeIndex + 1) % 3];
+                        const GeoSphereGridPoint midPoint = { (p0.i + p1.i) / 2, (p0.j + p1.j) / 2 };
+                        const size_t midPointIndex = gridPointIndex(midPoint);
+                        if (gridIndices[midPointIndex] != unassignedIndex)
+                        {
+                            continue;
+                        }
+
+                        DirectX::XMVECTOR xmvPos0 = DirectX::XMLoadFloat3(&gridPositions[gridPointIndex(p0)]);
+                        DirectX::XMVECTOR xmvPos1 = DirectX::XMLoadFloat3(&gridPositions[gridPointIndex(p1)]);
+                        xmvPos0 = DirectX::XMVectorAdd(xmvPos0, xmvPos1);
+                        xmvPos0 = DirectX::XMVector3Normalize(xmvPos0);
+                        VertexData vertexData;
+                        DirectX::XMStoreFloat3(&vertexData.normal, xmvPos0);
+
+                        xmvPos0 = DirectX::XMVectorScale(xmvPos0, radius);
+                        DirectX::XMStoreFloat3(&vertexData.position, xmvPos0);
+                        gridPositions[midPointIndex] = vertexData.position;
+
+                        // vertices on base edges owned by a lower face are written by that face, their indices are
+                        // looked up once all faces are done
+                        const int faceEdgeIndex = midPoint.j == 0 ? 0 : midPoint.i + midPoint.j == n ? 1 : midPoint.i == 0 ? 2 : -1;
+                        if (faceEdgeIndex >= 0 && edgeOwnership.owners[faceIndex][faceEdgeIndex] != faceIndex)
+                        {
+                            continue;
+                        }
+
+                        vertexData.uv = {
+                            DirectX::XMScalarACos(vertexData.normal.y) / DirectX::XM_PI,
+                            0.5f + std::atan2(vertexData.normal.x, vertexData.normal.z) / DirectX::XM_2PI,
+                        };
+
+                        gridIndices[midPointIndex] = static_cast<IndexType>(nextVertexIndex);
+                        vertexWriter.write(vertexBytes + nextVertexIndex * stride, vertexData);
+                        ++nextVertexIndex;
+
+                        xmvFaceMin = DirectX::XMVectorMin(xmvFaceMin, xmvPos0);
+                        xmvFaceMax = DirectX::XMVectorMax(xmvFaceMax, xmvPos0);
+                        xmvFaceMaxLengthSq = DirectX::XMVectorMax(xmvFaceMaxLengthSq, DirectX::XMVector3LengthSq(xmvPos0));
+                    }
+                };
+                visitGeoSphereTriangles(corners[0], corners[1], corners[2], static_cast<uint8_t>(level - 1u), splitEdges);
+            }
+
+            DirectX::XMStoreFloat3(&faceBoundsMin[faceIndex], xmvFaceMin);
+            DirectX::XMStoreFloat3(&faceBoundsMax[faceIndex], xmvFaceMax);
+            faceMaxLengthSq[faceIndex] = DirectX::XMVectorGetX(xmvFaceMaxLengthSq);
+        };
+
+        const auto writeFaceIndices = [&](const size_t faceIndex)
+        {
+            IndexType* const gridIndices = &gridIndicesPerFace[faceIndex * gridPointCount];
+
+            // copy indices of the vertices on shared edges from the owner face's grid
+            for (size_t edgeIndex = 0; edgeIndex < 3u; ++edgeIndex)
+            {
+                const size_t owner = edgeOwnership.owners[faceIndex][edgeIndex];
+                if (owner == faceIndex)
+                {
+                    continue;
+                }
+
+                const uint8_t* const ownerBaseIndices = &geoSphereBaseIndices[owner * 3];
+                const uint8_t v0 = geoSphereBaseIndices[faceIndex * 3 + edgeIndex];
+                const uint8_t v1 = geoSphereBaseIndices[faceIndex * 3 + (edgeIndex + 1) % 3];
+                const GeoSphereGridPoint& start = corners[edgeIndex];
+                const GeoSphereGridPoint& end = corners[(edgeIndex + 1) % 3];
+                const GeoSphereGridPoint& ownerStart = corners[std::find(ownerBaseIndices, ownerBaseIndices + 3, v0) - ownerBaseIndices];
+                const GeoSphereGridPoint& ownerEnd = corners[std::find(ownerBaseIndices, ownerBaseIndices + 3, v1) - ownerBaseIndices];
+                const IndexType* const ownerGridIndices = &gridIndicesPerFace[owner * gridPointCount];
+                for (int32_t step = 1; step < n; ++step)
+                {
+                    const GeoSphereGridPoint point = {
+                        start.i + step * (end.i - start.i) / n,
+                        start.j + step * (end.j - start.j) / n,
+                    };
+                    const GeoSphereGridPoint ownerPoint = {
+                        ownerStart.i + step * (ownerEnd.i - ownerStart.i) / n,
+                        ownerStart.j + step * (ownerEnd.j - ownerStart.j) / n,
+                    };
+                    gridIndices[gridPointIndex(point)] = ownerGridIndices[gridPointIndex(ownerPoint)];
+                }
+            }
+
+            // coarser levels use every 2^(subdivisions-level)th grid point, each level's faces are contiguous
+            IndexType* levelIndices = indices;
+            for (uint8_t level = minSubdivisions; level <= subdivisions; ++level)
+            {
+                const size_t faceIndexCount = 3u * (static_cast<size_t>(1u) << (level * 2));
+                IndexType* curIndex = levelIndices + faceIndex * faceIndexCount;
+                auto writeTriangle = [&](const GeoSphereGridPoint& a, const GeoSphereGridPoint& b, const GeoSphereGridPoint& c)
+                {
+                    *(curIndex++) = gridIndices[gridPointIndex(a)];
+                    *(curIndex++) = gridIndices[gridPointIndex(b)];
+                    *(curIndex++) = gridIndices[gridPointIndex(c)];
+                };
+                visitGeoSphereTriangles(corners[0], corners[1], corners[2], level, writeTriangle);
+                levelIndices += faceCount * faceIndexCount;
+            }
+        };
+
+        // all vertices of a face have to be assigned before other faces look up their shared edge indices, so the
+        // two passes run one after the other
+        const size_t faceThreadCount = ThreadUtil::getThreadCount(vertexCount, threadCount);
+        ThreadUtil::parallelFor(faceCount, [&](const size_t begin, const size_t end)
+        {
+            for (size_t faceIndex = begin; faceIndex < end; ++faceIndex)
+            {
+                generateFaceVertices(faceIndex);
+            }
+            vertexWriter.finishWrites();
+        }, faceThreadCount);
+        ThreadUtil::parallelFor(faceCount, [&](const size_t begin, const size_t end)
+        {
+            for (size_t faceIndex = begin; faceIndex < end; ++faceIndex)
+            {
+                writeFaceIndices(faceIndex);
+            }
+        }, faceThreadCount);
+
+        for (size_t faceIndex = 0; faceIndex < faceCount; ++faceIndex)
+        {
+            xmvBoundsMin = DirectX::XMVectorMin(xmvBoundsMin, DirectX::XMLoadFloat3(&faceBoundsMin[faceIndex]));
+            xmvBoundsMax = DirectX::XMVectorMax(xmvBoundsMax, DirectX::XMLoadFloat3(&faceBoundsMax[faceIndex]));
+            xmvMaxLengthSq = DirectX::XMVectorMax(xmvMaxLengthSq, DirectX::XMVectorReplicate(faceMaxLengthSq[faceIndex]));
+        }
+        Bounds bounds;
+        DirectX::XMStoreFloat3(&bounds.aabbMin, xmvBoundsMin);
+        DirectX::XMStoreFloat3(&bounds.aabbMax, xmvBoundsMax);
+        bounds.sphereCenter = { 0.0f, 0.0f, 0.0f };
+        bounds.sphereRadius = DirectX::XMVectorGetX(DirectX::XMVectorSqrt(xmvMaxLengthSq));
+        return bounds;
+    }
+
+    template <typename IndexType, typename VertexWriter>
+    Bounds createGeoSphere(const float radius, const uint8_t subdivisions, void* const vertices, IndexType* const indices, const VertexWriter& vertexWriter, const size_t threadCount = 0u)
+    {
+        return createGeoSphereLevels(radius, subdivisions, subdivisions, vertices, indices, vertexWriter, threadCount);
+    }
+
+    template <typename IndexType, typename VertexWriter>
+    Bounds createGeoSphereLodChain(const float radius, const uint8_t maxSubdivisions, void* const vertices, IndexType* const indices, GeoSphereLod* const lods, const VertexWriter& vertexWriter, const size_t threadCount = 0u)
+    {
+        size_t startIndex = 0;
+        for (uint8_t level = 0; level <= maxSubdivisions; ++level)
+        {
+            calculateVertexIndexCountsGeoSphere(level, lods[level].vertexCount, lods[level].indexCount);
+            lods[level].startIndex = startIndex;
+            startIndex += lods[level].indexCount;
+        }
+        return createGeoSphereLevels(radius, 0u, maxSubdivisions, vertices, indices, vertexWriter, threadCount);
+    }
+
+    template <typename IndexType, typename VertexWriter>
+    Bounds createSquare(const float width, const uint32_t vertexCountPerSide, void* const vertices, IndexType* const indices, const VertexWriter& vertexWriter, const size_t threadCount = 0u)
+    {
+        PROFILE_ZONE("GeometryUtil::createSquare");
+        const size_t vertexCount = static_cast<size_t>(vertexCountPerSide) * vertexCountPerSide;
+        assert(canIndexVertexCount<IndexType>(vertexCount));
+
+        const float stepSize = width / (vertexCountPerSide - 1);
+        const float start = -width / 2.0f;
+        const float uvDivisor = static_cast<float>(vertexCountPerSide - 1);
+
+        const size_t stride = vertexWriter.getStride();
+        uint8_t* const vertexBytes = reinterpret_cast<uint8_t*>(vertices);
+
+        // Coordinates are computed as start + offset * stepSize instead of being accumulated, so rows can be written
+        // independently and the 4 wide path matches the scalar one. Packed float layouts get four vertices per
+        // iteration as eight vector stores, other layouts go through the writer one vertex at a time.
+        const auto writeRows = [&](const size_t beginRow, const size_t endRow)
+        {
+            for (size_t xOffset = beginRow; xOffset < endRow; ++xOffset)
+            {
+                VertexData vertexData;
+                vertexData.position.y = 0.0f;
+                vertexData.position.z = start + static_cast<float>(xOffset) * stepSize;
+                vertexData.uv.x = static_cast<float>(xOffset) / uvDivisor;
+                vertexData.normal = { 0.0f, 1.0f, 0.0f };
+
+                uint8_t* curVertexByte = vertexBytes + xOffset * vertexCountPerSide * stride;
+                uint32_t yOffset = 0;
+                if constexpr (isPackedFloatVertexWriter<VertexWriter>)
+                {
+                    // (position.x, position.y, position.z, uv.x) and (uv.y, normal.x, normal.y, normal.z), the x lanes
+                    // differ between the vertices of a row
+                    const DirectX::XMVECTOR xmvRowHead = DirectX::XMVectorSet(0.0f, vertexData.position.y, vertexData.position.z, vertexData.uv.x);
+                    const DirectX::XMVECTOR xmvRowTail = DirectX::XMVectorSet(0.0f, vertexData.normal.x, vertexData.normal.y, vertexData.normal.z);
+                    const DirectX::XMVECTOR xmvLaneOffsets = DirectX::XMVectorSet(0.0f, 1.0f, 2.0f, 3.0f);
+                    const DirectX::XMVECTOR xmvStart = DirectX::XMVectorReplicate(start);
+                    const DirectX::XMVECTOR xmvStepSize = DirectX::XMVectorReplicate(stepSize);
+                    const DirectX::XMVECTOR xmvUvDivisor = DirectX::XMVectorReplicate(uvDivisor);
+                    const auto storeVertex = [&](uint8_t* const pVertex, DirectX::FXMVECTOR xmvPositionX, DirectX::FXMVECTOR xmvUvY)
+                    {
+                        DirectX::XMStoreFloat4(reinterpret_cast<DirectX::XMFLOAT4*>(pVertex), DirectX::XMVectorSelect(xmvRowHead, xmvPositionX, DirectX::g_XMSelect1000));
+                        DirectX::XMStoreFloat4(reinterpret_cast<DirectX::XMFLOAT4*>(pVertex + 16u), DirectX::XMVectorSelect(xmvRowTail, xmvUvY, DirectX::g_XMSelect1000));
+                    };
+                    for (; yOffset + 4u <= vertexCountPerSide; yOffset += 4u)
+                    {
+                        const DirectX::XMVECTOR xmvOffsets = DirectX::XMVectorAdd(DirectX::XMVectorReplicate(static_cast<float>(yOffset)), xmvLaneOffsets);
+                        const DirectX::XMVECTOR xmvPositionsX = DirectX::XMVectorAdd(xmvStart, DirectX::XMVectorMultiply(xmvOffsets, xmvStepSize));
+                        const DirectX::XMVECTOR xmvUvsY = DirectX::XMVectorDivide(xmvOffsets, xmvUvDivisor);
+                        storeVertex(curVertexByte, DirectX::XMVectorSplatX(xmvPositionsX), DirectX::XMVectorSplatX(xmvUvsY));
+                        storeVertex(curVertexByte + 32u, DirectX::XMVectorSplatY(xmvPositionsX), DirectX::XMVectorSplatY(xmvUvsY));
+                        storeVertex(curVertexByte + 64u, DirectX::XMVectorSplatZ(xmvPositionsX), DirectX::XMVectorSplatZ(xmvUvsY));
+                        storeVertex(curVertexByte + 96u, DirectX::XMVectorSplatW(xmvPositionsX), DirectX::XMVectorSplatW(xmvUvsY));
+                        curVertexByte += 128u;
+                    }
+                }
+                for (; yOffset < vertexCountPerSide; ++yOffset)
+                {
+                    vertexData.position.x = start + static_cast<float>(yOffset) * stepSize;
+                    vertexData.uv.y = static_cast<float>(yOffset) / uvDivisor;
+                    vertexWriter.write(curVertexByte, vertexData);
+                    curVertexByte += stride;
+                }
+            }
+            vertexWriter.finishWrites();
+        };
+
+        const auto writeQuads = [&](const size_t beginColumn, const size_t endColumn)
+        {
+            IndexType* curIndex = indices + beginColumn * (vertexCountPerSide - 1) * 6u;
+            for (uint32_t xOffset = static_cast<uint32_t>(beginColumn); xOffset < endColumn; ++xOffset)
+            {
+                for (uint32_t yOffset = 0; yOffset < vertexCountPerSide - 1; ++yOffset)
+                {
+                    const uint32_t index = yOffset * vertexCountPerSide + xOffset;
+                    const uint32_t indexNextRow = index + vertexCountPerSide;
+
+                    *(curIndex++) = static_cast<IndexType>(index);
+                    *(curIndex++) = static_cast<IndexType>(index + 1);
+                    *(curIndex++) = static_cast<IndexType>(indexNextRow);
+
+                    *(curIndex++) = static_cast<IndexType>(indexNextRow);
+                    *(curIndex++) = static_cast<IndexType>(index + 1);
+                    *(curIndex++) = static_cast<IndexType>(indexNextRow + 1);
+                }
+            }
+        };
+
+        // bands of rows and of quad columns go to separate threads
+        const size_t bandThreadCount = ThreadUtil::getThreadCount(vertexCount, threadCount);
+        ThreadUtil::parallelFor(vertexCountPerSide, writeRows, bandThreadCount);
+        ThreadUtil::parallelFor(vertexCountPerSide - 1u, writeQuads, bandThreadCount);
+
+        // the first and last vertex of every row are the extremes, computed the same way as the rows compute them
+        const float end = start + static_cast<float>(vertexCountPerSide - 1) * stepSize;
+        return calculateBoxBounds({ start, 0.0f, start }, { end, 0.0f, end });
+    }
+
+    // compile time layout variants, e.g. createSquare<defaultVertexDesc>(width, vertexCountPerSide, vertices, indices)
+    template <const VertexDesc& vertexDesc, typename IndexType>
+    Bounds createGeoSphere(const float radius, const uint8_t subdivisions, void* const vertices, IndexType* const indices, const size_t threadCount = 0u)
+    {
+        return createGeoSphere(radius, subdivisions, vertices, indices, StaticVertexWriter<vertexDesc>(), threadCount);
+    }
+
+    template <const VertexDesc& vertexDesc, typename IndexType>
+    Bounds createGeoSphereLodChain(const float radius, const uint8_t maxSubdivisions, void* const vertices, IndexType* const indices, GeoSphereLod* const lods, const size_t threadCount = 0u)
+    {
+        return createGeoSphereLodChain(radius, maxSubdivisions, vertices, indices, lods, StaticVertexWriter<vertexDesc>(), threadCount);
+    }
+
+    template <const VertexDesc& vertexDesc, typename IndexType>
+    Bounds createSquare(const float width, const uint32_t vertexCountPerSide, void* const vertices, IndexType* const indices, const size_t threadCount = 0u)
+    {
+        return createSquare(width, vertexCountPerSide, vertices, indices, StaticVertexWriter<vertexDesc>(), threadCount);
+    }
+
+    // compile time layout writer for write-combined memory, e.g.
+    // createGeoSphere(radius, subdivisions, pMappedVertices, pMappedIndices, StaticWriteCombinedVertexWriter<defaultVertexDesc>())
+    template <const VertexDesc& vertexDesc>
+    using StaticWriteCombinedVertexWriter = WriteCombinedVertexWriter<StaticVertexWriter<vertexDesc>>;
+
+    // constexpr stand-ins for the other <cmath> functions the compile time generators need, see constexprSqrt
+    constexpr double constexprAtan(const double x)
+    {
+        constexpr double pi = 3.14159265358979323846;
+        if (x < 0.0)
+        {
+            return -constexprAtan(-x);
+        }
+        if (x > 1.0)
+        {
+            return 0.5 * pi - constexprAtan(1.0 / x);
+        }
+
+        // atan(x) = 2 atan(x / (1 + sqrt(1 + x^2))) twice brings x below tan(pi/16), where the series converges quickly
+        double reduced = x;
+        for (int halving = 0; halving < 2; ++halving)
+        {
+            reduced = reduced / (1.0 + constexprSqrt(1.0 + reduced * reduced));
+        }
+        double sum = 0.0;
+        double power = reduced;
+        for (int exponent = 1; exponent < 40; exponent += 2)
+        {
+            sum += (exponent % 4 == 1 ? power : -power) / exponent;
+            power *= reduced * reduced;
+        }
+        return 4.0 * sum;
+    }
+
+    constexpr double constexprAtan2(const double y, const double x)
+    {
+        constexpr double pi = 3.14159265358979323846;
+        if (x > 0.0)
+        {
+            return constexprAtan(y / x);
+        }
+        if (x < 0.0)
+        {
+            return y >= 0.0 ? constexprAtan(y / x) + pi : constexprAtan(y / x) - pi;
+        }
+        return y > 0.0 ? 0.5 * pi : y < 0.0 ? -0.5 * pi : 0.0;
+    }
+
+    constexpr double constexprACos(const double x)
+    {
+        return constexprAtan2(constexprSqrt(1.0 - x * x), x);
+    }
+
+    // Vertices and indices of a small mesh generated at compile time, so it costs nothing at startup, e.g.
+    //     static constexpr auto quad = createStaticSquare<2u, uint16_t>(1.0f, makeVertex);
+    // makeVertex is a constexpr function object turning VertexData into the vertex type stored in the array. The
+    // results, bounds included, match createSquare and createGeoSphere up to rounding. Compile times grow with the mesh size, this is
+    // meant for squares with a few hundred vertices and geospheres with up to 3 subdivisions. A 3 subdivision
+    // geosphere takes a few million evaluation steps, more than MSVC allows by default, see /constexpr:steps.
+    template <typename Vertex, typename IndexType, size_t vertexCount, size_t indexCount>
+    struct StaticMesh
+    {
+        std::array<Vertex, vertexCount> vertices;
+        std::array<IndexType, indexCount> indices;
+        Bounds bounds;
+    };
+
+    template <uint32_t vertexCountPerSide, typename IndexType, typename MakeVertex>
+    constexpr auto createStaticSquare(const float width, const MakeVertex& makeVertex)
+    {
+        constexpr std::array<size_t, 2> counts = []()
+        {
+            std::array<size_t, 2> result = {};
+            calculateVertexIndexCountsSquare(vertexCountPerSide, result[0], result[1]);
+            return result;
+        }();
+        static_assert(canIndexVertexCount<IndexType>(counts[0]), "the index type cannot address every vertex of the square");
+
+        using Vertex = std::decay_t<decltype(makeVertex(std::declval<const VertexData&>()))>;
+        StaticMesh<Vertex, IndexType, counts[0], counts[1]> mesh = {};
+
+        const float stepSize = width / (vertexCountPerSide - 1);
+        const float start = -width / 2.0f;
+        const float uvDivisor = static_cast<float>(vertexCountPerSide - 1);
+        for (uint32_t xOffset = 0; xOffset < vertexCountPerSide; ++xOffset)
+        {
+            for (uint32_t yOffset = 0; yOffset < vertexCountPerSide; ++yOffset)
+            {
+                const VertexData vertexData = {
+                    { start + static_cast<float>(yOffset) * stepSize, 0.0f, start + static_cast<float>(xOffset) * stepSize },
+                    { static_cast<float>(xOffset) / uvDivisor, static_cast<float>(yOffset) / uvDivisor },
+                    { 0.0f, 1.0f, 0.0f },
+                };
+                mesh.vertices[xOffset * vertexCountPerSide + yOffset] = makeVertex(vertexData);
+            }
+        }
+
+        size_t curIndex = 0;
+        for (uint32_t xOffset = 0; xOffset < vertexCountPerSide - 1; ++xOffset)
+        {
+            for (uint32_t yOffset = 0; yOffset < vertexCountPerSide - 1; ++yOffset)
+            {
+                const uint32_t index = yOffset * vertexCountPerSide + xOffset;
+                const uint32_t indexNextRow = index + vertexCountPerSide;
+
+                mesh.indices[curIndex++] = static_cast<IndexType>(index);
+                mesh.indices[curIndex++] = static_cast<IndexType>(index + 1);
+                mesh.indices[curIndex++] = static_cast<IndexType>(indexNextRow);
+
+                mesh.indices[curIndex++] = static_cast<IndexType>(indexNextRow);
+                mesh.indices[curIndex++] = static_cast<IndexType>(index + 1);
+                mesh.indices[curIndex++] = static_cast<IndexType>(indexNextRow + 1);
+            }
+        }
+
+        const float end = start + static_cast<float>(vertexCountPerSide - 1) * stepSize;
+        mesh.bounds = calculateBoxBounds({ start, 0.0f, start }, { end, 0.0f, end });
+        return mesh;
+    }
+
+    // Subdivides level by level, which numbers vertices and orders triangles the same way as createGeoSphere.
+    template <uint8_t subdivisions, typename IndexType, typename MakeVertex>
+    constexpr auto createStaticGeoSphere(const float radius, const MakeVertex& makeVertex)
+    {
+        constexpr std::array<size_t, 2> counts = []()
+        {
+            std::array<size_t, 2> result = {};
+            calculateVertexIndexCountsGeoSphere(subdivisions, result[0], result[1]);
+            return result;
+        }();
+        static_assert(canIndexVertexCount<IndexType>(counts[0]), "the index type cannot address every vertex of the geosphere");
+
+        using Vertex = std::decay_t<decltype(makeVertex(std::declval<const VertexData&>()))>;
+        StaticMesh<Vertex, IndexType, counts[0], counts[1]> mesh = {};
+
+        const float phi = 1.6180339887f;
+        const float normalizationFactor = radius / static_cast<float>(constexprSqrt(phi * phi + 1.0f));
+        const float phiNorm = phi * normalizationFactor;
+        const float oneNorm = normalizationFactor;
+        const DirectX::XMFLOAT3 baseVertexPositions[] = {
+            {0.0f,  phiNorm,  oneNorm},
+            {0.0f,  phiNorm, -oneNorm},
+            {0.0f, -phiNorm,  oneNorm},
+            {0.0f, -phiNorm, -oneNorm},
+            {-oneNorm, 0.0f,  phiNorm},
+            { oneNorm, 0.0f,  phiNorm},
+            {-oneNorm, 0.0f, -phiNorm},
+            { oneNorm, 0.0f, -phiNorm},
+            {-phiNorm,  oneNorm, 0.0f},
+            { phiNorm,  oneNorm, 0.0f},
+            {-phiNorm, -oneNorm, 0.0f},
+            { phiNorm, -oneNorm, 0.0f},
+        };
+
+        std::array<DirectX::XMFLOAT3, counts[0]> positions = {};
+        std::array<DirectX::XMFLOAT3, counts[0]> normals = {};
+        for (size_t baseVertexId = 0; baseVertexId < 12u; ++baseVertexId)
+        {
+            positions[baseVertexId] = baseVertexPositions[baseVertexId];
+            normals[baseVertexId] = {
+                baseVertexPositions[baseVertexId].x * (1.0f / radius),
+                baseVertexPositions[baseVertexId].y * (1.0f / radius),
+                baseVertexPositions[baseVertexId].z * (1.0f / radius),
+            };
+        }
+        for (size_t index = 0; index < 60u; ++index)
+        {
+            mesh.indices[index] = geoSphereBaseIndices[index];
+        }
+
+        // every split triangle (a, b, c) becomes (a, ab, ca), (b, bc, ab), (c, ca, bc), (ab, bc, ca), and new vertices
+        // are numbered in the order the triangles reach their edges
+        std::array<IndexType, counts[1]> splitIndices = {};
+        size_t vertexCount = 12u;
+        size_t triangleCount = 20u;
+        for (uint8_t level = 1u; level <= subdivisions; ++level)
+        {
+            // edges are found from their lower vertex, which has at most 6 neighbours
+            std::array<IndexType, counts[0] * 6u> edgeEnds = {};
+            std::array<IndexType, counts[0] * 6u> edgeMidpoints = {};
+            std::array<uint8_t, counts[0]> edgeCounts = {};
+
+            for (size_t triangle = 0; triangle < triangleCount; ++triangle)
+            {
+                IndexType midpoints[3] = {};
+                for (size_t edgeIndex = 0; edgeIndex < 3u; ++edgeIndex)
+                {
+                    const IndexType v0 = mesh.indices[triangle * 3u + edgeIndex];
+                    const IndexType v1 = mesh.indices[triangle * 3u + (edgeIndex + 1u) % 3u];
+                    const IndexType lower = v0 < v1 ? v0 : v1;
+                    const IndexType upper = v0 < v1 ? v1 : v0;
+
+                    size_t edge = 0;
+                    while (edge < edgeCounts[lower] && edgeEnds[lower * 6u + edge] != upper)
+                    {
+                        ++edge;
+                    }
+                    if (edge < edgeCounts[lower])
+                    {
+                        midpoints[edgeIndex] = edgeMidpoints[lower * 6u + edge];
+                        continue;
+                    }
+
+                    const DirectX::XMFLOAT3 sum = {
+                        positions[v0].x + positions[v1].x,
+                        positions[v0].y + positions[v1].y,
+                        positions[v0].z + positions[v1].z,
+                    };
+                    const float length = static_cast<float>(constexprSqrt(sum.x * sum.x + sum.y * sum.y + sum.z * sum.z));
+                    normals[vertexCount] = { sum.x / length, sum.y / length, sum.z / length };
+                    positions[vertexCount] = { normals[vertexCount].x * radius, normals[vertexCount].y * radius, normals[vertexCount].z * radius };
+
+                    midpoints[edgeIndex] = static_cast<IndexType>(vertexCount);
+                    edgeEnds[lower * 6u + edge] = upper;
+                    edgeMidpoints[lower * 6u + edge] = static_cast<IndexType>(vertexCount);
+                    ++edgeCounts[lower];
+                    ++vertexCount;
+                }
+
+                const IndexType a = mesh.indices[triangle * 3u];
+                const IndexType b = mesh.indices[triangle * 3u + 1u];
+                const IndexType c = mesh.indices[triangle * 3u + 2u];
+                const IndexType ab = midpoints[0];
+                const IndexType bc = midpoints[1];
+                const IndexType ca = midpoints[2];
+                const IndexType children[] = { a, ab, ca, b, bc, ab, c, ca, bc, ab, bc, ca };
+                for (size_t child = 0; child < 12u; ++child)
+                {
+                    splitIndices[triangle * 12u + child] = children[child];
+                }
+            }
+
+            triangleCount *= 4u;
+            for (size_t index = 0; index < triangleCount * 3u; ++index)
+            {
+                mesh.indices[index] = splitIndices[index];
+            }
+        }
+
+        mesh.bounds = { positions[0], positions[0], { 0.0f, 0.0f, 0.0f }, 0.0f };
+        float maxLengthSq = 0.0f;
+        for (const DirectX::XMFLOAT3& position : positions)
+        {
+            mesh.bounds.aabbMin = { std::min(mesh.bounds.aabbMin.x, position.x), std::min(mesh.bounds.aabbMin.y, position.y), std::min(mesh.bounds.aabbMin.z, position.z) };
+            mesh.bounds.aabbMax = { std::max(mesh.bounds.aabbMax.x, position.x), std::max(mesh.bounds.aabbMax.y, position.y), std::max(mesh.bounds.aabbMax.z, position.z) };
+            maxLengthSq = std::max(maxLengthSq, position.x * position.x + position.y * position.y + position.z * position.z);
+        }
+        mesh.bounds.sphereRadius = static_cast<float>(constexprSqrt(maxLengthSq));
+
+        constexpr double pi = 3.14159265358979323846;
+        for (size_t vertex = 0; vertex < counts[0]; ++vertex)
+        {
+            const VertexData vertexData = {
+                positions[vertex],
+                {
+                    static_cast<float>(constexprACos(normals[vertex].y) / pi),
+                    static_cast<float>(0.5 + constexprAtan2(normals[vertex].x, normals[vertex].z) / (2.0 * pi)),
+                },
+                normals[vertex],
+            };
+            mesh.vertices[vertex] = makeVertex(vertexData);
+        }
+        return mesh;
+    }
+}
@@ -2,6 +2,8 @@
 #include "DebugUtil.h"
 #include "D3D12Util.h"
 
+#include <vector>
+
 void Mesh::createVertexBuffer(const void* const data, const size_t vertexCount, const size_t vertexSize, ID3D12GraphicsCommandList* const pCommandList, const size_t index)
 {
     m_vertexCount = vertexCount;
@@ -14,8 +16,26 @@ void Mesh::createVertexBuffer(const void* const data, const size_t vertexCount,
     pCommandList->ResourceBarrier(1, &barrier);
 }
 
+void Mesh::createVertexBuffer(const void* const data, const size_t vertexCount, const GeometryUtil::VertexDesc& vertexDesc, ID3D12GraphicsCommandList* const pCommandList, const size_t index)
+{
+    createVertexBuffer(data, vertexCount, vertexDesc.stride, pCommandList, index);
+    m_bounds = GeometryUtil::calculateBounds(data, vertexDesc, vertexCount);
+}
+
 void Mesh::createIndexBuffer(const void* const data, const size_t indexCount, const size_t indexSize, ID3D12GraphicsCommandList* const pCommandList)
 {
+    if (indexSize == sizeof(uint32_t) && m_vertexCount != 0u && selectIndexSize(m_vertexCount) == sizeof(uint16_t))
+    {
+        const uint32_t* const pIndices = static_cast<const uint32_t*>(data);
+        std::vector<uint16_t> narrowedIndices(indexCount);
+        for (size_t i = 0; i < indexCount; ++i)
+        {
+            narrowedIndices[i] = static_cast<uint16_t>(pIndices[i]);
+        }
+        createIndexBuffer(narrowedIndices.data(), indexCount, sizeof(uint16_t), pCommandList);
+        return;
+    }
+
     m_indexCount = indexCount;
     m_indexSize = indexSize;
 
@@ -26,6 +46,32 @@ void Mesh::createIndexBuffer(const void* const data, const size_t indexCount, co
     pCommandList->ResourceBarrier(1, &barrier);
 }
 
+void* Mesh::createVertexBufferForWriting(const size_t vertexCount, const size_t vertexSize, ID3D12GraphicsCommandList* const pCommandList, const size_t index)
+{
+    m_vertexCount = vertexCount;
+    m_vertexSize[index] = vertexSize;
+
+    void* const pMappedVertices = D3D12Util::createBufferForUpload(vertexCount * vertexSize, pCommandList, &m_pVertexBuffer[index], &m_pVertexBufferUpload[index]);
+
+    const D3D12_RESOURCE_BARRIER barrier = D3D12Util::TransitionBarrier(m_pVertexBuffer[index].Get(),
+        D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER);
+    pCommandList->ResourceBarrier(1, &barrier);
+    return pMappedVertices;
+}
+
+void* Mesh::createIndexBufferForWriting(const size_t indexCount, const size_t indexSize, ID3D12GraphicsCommandList* const pCommandList)
+{
+    m_indexCount = indexCount;
+    m_indexSize = indexSize;
+
+    void* const pMappedIndices = D3D12Util::createBufferForUpload(indexCount * indexSize, pCommandList, &m_pIndexBuffer, &m_pIndexBufferUpload);
+
+    const D3D12_RESOURCE_BARRIER barrier = D3D12Util::TransitionBarrier(m_pIndexBuffer.Get(),
+        D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_INDEX_BUFFER);
+    pCommandList->ResourceBarrier(1, &barrier);
+    return pMappedIndices;
+}
+
 D3D12_VERTEX_BUFFER_VIEW Mesh::getVertexBufferView(const size_t index) const
 {
     D3D12_VERTEX_BUFFER_VIEW vertexBufferView = {};
@@ -39,7 +85,7 @@ D3D12_INDEX_BUFFER_VIEW Mesh::getIndexBufferView() const
 {
     D3D12_INDEX_BUFFER_VIEW indexBufferView = {};
     indexBufferView.BufferLocation = m_pIndexBuffer->GetGPUVirtualAddress();
-    indexBufferView.Format = DXGI_FORMAT_R16_UINT;
+    indexBufferView.Format = m_indexSize == sizeof(uint32_t) ? DXGI_FORMAT_R32_UINT : DXGI_FORMAT_R16_UINT;
     indexBufferView.SizeInBytes = static_cast<UINT>(m_indexCount * m_indexSize);
     return indexBufferView;
 }
@@ -1,19 +1,39 @@
 #pragma once
 
+#include <cstdint>
+#include <type_traits>
 #include <vector>
 #include "d3d12.h"
 #include "wrl.h"
 
+#include "GeometryUtil.h"
+
 struct Mesh
 {
     void createVertexBuffer(const void* const data, const size_t vertexCount, const size_t vertexSize, ID3D12GraphicsCommandList* const pCommandList, const size_t index = 0);
+    // same as above with the stride of vertexDesc, and m_bounds calculated from the positions on the way
+    void createVertexBuffer(const void* const data, const size_t vertexCount, const GeometryUtil::VertexDesc& vertexDesc, ID3D12GraphicsCommandList* const pCommandList, const size_t index = 0);
+    // 4 byte indices are uploaded as 2 byte ones if selectIndexSize allows it for the vertex buffer created before
     void createIndexBuffer(const void* const data, const size_t indexCount, const size_t indexSize, ID3D12GraphicsCommandList* const pCommandList);
+    // Same as above, but return the mapped upload buffer for the caller to fill before the command list is executed,
+    // e.g. by generating geometry straight into it with GeometryUtil::WriteCombinedVertexWriter. Write only.
+    // The generators return the bounds to store in m_bounds.
+    void* createVertexBufferForWriting(const size_t vertexCount, const size_t vertexSize, ID3D12GraphicsCommandList* const pCommandList, const size_t index = 0);
+    void* createIndexBufferForWriting(const size_t indexCount, const size_t indexSize, ID3D12GraphicsCommandList* const pCommandList);
 
     D3D12_VERTEX_BUFFER_VIEW getVertexBufferView(const size_t index = 0) const;
     D3D12_INDEX_BUFFER_VIEW getIndexBufferView() const;
 
     static constexpr size_t MAX_VERTEX_BUFFERS = 4u;
 
+    // prefer 16 bit indices whenever they suffice, they halve index memory and fetch bandwidth
+    template <size_t vertexCount>
+    using IndexTypeFor = std::conditional_t<vertexCount <= (static_cast<size_t>(1u) << 16), uint16_t, uint32_t>;
+    static constexpr size_t selectIndexSize(const size_t vertexCount)
+    {
+        return vertexCount <= (static_cast<size_t>(1u) << 16) ? sizeof(uint16_t) : sizeof(uint32_t);
+    }
+
     Microsoft::WRL::ComPtr<ID3D12Resource> m_pVertexBuffer[MAX_VERTEX_BUFFERS];
     Microsoft::WRL::ComPtr<ID3D12Resource> m_pVertexBufferUpload[MAX_VERTEX_BUFFERS];
 
@@ -21,7 +41,10 @@ struct Mesh
     Microsoft::WRL::ComPtr<ID3D12Resource> m_pIndexBufferUpload;
 
     size_t m_vertexSize[MAX_VERTEX_BUFFERS];
-    size_t m_vertexCount;
+    size_t m_vertexCount = 0u;
     size_t m_indexSize;
     size_t m_indexCount;
+
+    // object space bounds of the vertices, for culling
+    GeometryUtil::Bounds m_bounds = {};
 };
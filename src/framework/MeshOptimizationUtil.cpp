@@ -0,0 +1,233 @@
+#include "MeshOptimizationUtil.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "TriangleAdjacency.h"
+
+namespace
+{
+    // scoring parameters from Tom Forsyth, "Linear-Speed Vertex Cache Optimisation"
+    constexpr size_t simulatedCacheSize = 32u;
+    constexpr float cacheDecayPower = 1.5f;
+    constexpr float lastTriangleScore = 0.75f;
+    constexpr float valenceBoostScale = 2.0f;
+    constexpr float valenceBoostPower = 0.5f;
+    constexpr size_t valenceScoreTableSize = 32u;
+
+    struct VertexScoreTables
+    {
+        VertexScoreTables()
+        {
+            for (size_t cachePosition = 0; cachePosition < simulatedCacheSize; ++cachePosition)
+            {
+                // vertices of the last triangle get a fixed score so its neighbours are not favoured over other
+                // recently used triangles
+                cacheScores[cachePosition] = cachePosition < 3u ? lastTriangleScore :
+                    std::pow(1.0f - static_cast<float>(cachePosition - 3u) / static_cast<float>(simulatedCacheSize - 3u), cacheDecayPower);
+            }
+            valenceScores[0] = 0.0f;
+            for (size_t valence = 1; valence < valenceScoreTableSize; ++valence)
+            {
+                valenceScores[valence] = valenceBoostScale * std::pow(static_cast<float>(valence), -valenceBoostPower);
+            }
+        }
+
+        float cacheScores[simulatedCacheSize];
+        float valenceScores[valenceScoreTableSize];
+    };
+
+    float computeVertexScore(const VertexScoreTables& tables, const int32_t cachePosition, const uint32_t liveTriangleCount)
+    {
+        if (liveTriangleCount == 0u)
+        {
+            // no triangles left to emit
+            return -1.0f;
+        }
+
+        float score = cachePosition >= 0 ? tables.cacheScores[cachePosition] : 0.0f;
+        // boost vertices with few remaining triangles so they get finished instead of leaving lone triangles behind
+        score += liveTriangleCount < valenceScoreTableSize ? tables.valenceScores[liveTriangleCount] :
+            valenceBoostScale * std::pow(static_cast<float>(liveTriangleCount), -valenceBoostPower);
+        return score;
+    }
+}
+
+namespace MeshOptimizationUtil
+{
+    template <typename IndexType>
+    VertexCacheStatistics analyzeVertexCache(const IndexType* const indices, const size_t indexCount, const size_t vertexCount, const size_t cacheSize)
+    {
+        // timestamp of the transform that put a vertex into the cache, 0 if it was never transformed. A vertex is pushed
+        // out of the FIFO after cacheSize further transforms.
+        std::vector<size_t> cacheTimestamps(vertexCount, 0u);
+        size_t transformedVertexCount = 0;
+        size_t referencedVertexCount = 0;
+        for (size_t i = 0; i < indexCount; ++i)
+        {
+            size_t& cacheTimestamp = cacheTimestamps[indices[i]];
+            if (cacheTimestamp == 0u)
+            {
+                ++referencedVertexCount;
+            }
+            if (cacheTimestamp == 0u || transformedVertexCount - cacheTimestamp >= cacheSize)
+            {
+                cacheTimestamp = ++transformedVertexCount;
+            }
+        }
+
+        VertexCacheStatistics statistics = {};
+        statistics.transformedVertexCount = transformedVertexCount;
+        statistics.acmr = indexCount > 0u ? static_cast<float>(transformedVertexCount) / static_cast<float>(indexCount / 3u) : 0.0f;
+        statistics.atvr = referencedVertexCount > 0u ? static_cast<float>(transformedVertexCount) / static_cast<float>(referencedVertexCount) : 0.0f;
+        return statistics;
+    }
+
+    template <typename IndexType>
+    void optimizeVertexCache(IndexType* const destination, const IndexType* const indices, const size_t indexCount, const size_t vertexCount)
+    {
+        assert(destination != indices);
+        assert(indexCount % 3u == 0u);
+
+        static const VertexScoreTables scoreTables;
+        const size_t triangleCount = indexCount / 3u;
+
+        TriangleAdjacency adjacency;
+        adjacency.build(indices, indexCount, vertexCount);
+
+        std::vector<int32_t> cachePositions(vertexCount, -1);
+        std::vector<float> vertexScores(vertexCount);
+        for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+        {
+            vertexScores[vertex] = computeVertexScore(scoreTables, -1, adjacency.getLiveTriangleCount(vertex));
+        }
+
+        constexpr size_t noTriangle = std::numeric_limits<size_t>::max();
+        size_t bestTriangle = noTriangle;
+        float bestTriangleScore = -1.0f;
+        for (size_t triangle = 0; triangle < triangleCount; ++triangle)
+        {
+            const IndexType* const triangleIndices = &indices[triangle * 3u];
+            const float score = vertexScores[triangleIndices[0]] + vertexScores[triangleIndices[1]] + vertexScores[triangleIndices[2]];
+            if (score > bestTriangleScore)
+            {
+                bestTriangle = triangle;
+                bestTriangleScore = score;
+            }
+        }
+
+        std::vector<bool> emittedTriangles(triangleCount, false);
+        size_t inputCursor = 0;
+
+        // the emitted triangle's vertices are pushed to the front, so the cache temporarily holds up to 3 more entries
+        uint32_t cache[simulatedCacheSize + 3u];
+        size_t cacheCount = 0;
+
+        IndexType* curIndex = destination;
+        for (size_t emittedCount = 0; emittedCount < triangleCount; ++emittedCount)
+        {
+            if (bestTriangle == noTriangle)
+            {
+                // nothing adjacent to the cache is left, continue with the next triangle in input order
+                while (emittedTriangles[inputCursor])
+                {
+                    ++inputCursor;
+                }
+                bestTriangle = inputCursor;
+            }
+
+            const IndexType* const triangleIndices = &indices[bestTriangle * 3u];
+            *(curIndex++) = triangleIndices[0];
+            *(curIndex++) = triangleIndices[1];
+            *(curIndex++) = triangleIndices[2];
+            emittedTriangles[bestTriangle] = true;
+            adjacency.removeTriangle(static_cast<uint32_t>(bestTriangle), triangleIndices);
+
+            uint32_t newCache[simulatedCacheSize + 3u];
+            size_t newCacheCount = 0;
+            for (size_t corner = 0; corner < 3u; ++corner)
+            {
+                const uint32_t vertex = triangleIndices[corner];
+
+                // degenerate triangles reference a vertex more than once
+                if (std::find(newCache, newCache + newCacheCount, vertex) == newCache + newCacheCount)
+                {
+                    newCache[newCacheCount++] = vertex;
+                }
+            }
+            const size_t triangleVertexCount = newCacheCount;
+            for (size_t i = 0; i < cacheCount; ++i)
+            {
+                if (std::find(newCache, newCache + triangleVertexCount, cache[i]) == newCache + triangleVertexCount)
+                {
+                    newCache[newCacheCount++] = cache[i];
+                }
+            }
+
+            // vertices past the simulated cache size were just evicted
+            for (size_t i = 0; i < newCacheCount; ++i)
+            {
+                const uint32_t vertex = newCache[i];
+                cachePositions[vertex] = i < simulatedCacheSize ? static_cast<int32_t>(i) : -1;
+                vertexScores[vertex] = computeVertexScore(scoreTables, cachePositions[vertex], adjacency.getLiveTriangleCount(vertex));
+            }
+
+            bestTriangle = noTriangle;
+            bestTriangleScore = -1.0f;
+            for (size_t i = 0; i < newCacheCount; ++i)
+            {
+                const uint32_t vertex = newCache[i];
+                const uint32_t* const vertexTriangles = adjacency.getTriangles(vertex);
+                for (uint32_t j = 0; j < adjacency.getLiveTriangleCount(vertex); ++j)
+                {
+                    const uint32_t triangle = vertexTriangles[j];
+                    const IndexType* const adjacentTriangleIndices = &indices[triangle * 3u];
+                    const float score = vertexScores[adjacentTriangleIndices[0]] + vertexScores[adjacentTriangleIndices[1]] + vertexScores[adjacentTriangleIndices[2]];
+                    if (score > bestTriangleScore)
+                    {
+                        bestTriangle = triangle;
+                        bestTriangleScore = score;
+                    }
+                }
+            }
+
+            cacheCount = newCacheCount < simulatedCacheSize ? newCacheCount : simulatedCacheSize;
+            std::memcpy(cache, newCache, cacheCount * sizeof(uint32_t));
+        }
+    }
+
+    template <typename IndexType>
+    size_t optimizeVertexFetch(void* const destinationVertices, IndexType* const indices, const size_t indexCount, const void* const vertices, const size_t vertexCount, const size_t vertexSize)
+    {
+        assert(destinationVertices != vertices);
+
+        constexpr uint32_t unassigned = std::numeric_limits<uint32_t>::max();
+        std::vector<uint32_t> remap(vertexCount, unassigned);
+
+        uint8_t* const dstBytes = reinterpret_cast<uint8_t*>(destinationVertices);
+        const uint8_t* const srcBytes = reinterpret_cast<const uint8_t*>(vertices);
+        uint32_t nextVertex = 0;
+        for (size_t i = 0; i < indexCount; ++i)
+        {
+            uint32_t& newIndex = remap[indices[i]];
+            if (newIndex == unassigned)
+            {
+                newIndex = nextVertex++;
+                std::memcpy(dstBytes + newIndex * vertexSize, srcBytes + indices[i] * vertexSize, vertexSize);
+            }
+            indices[i] = static_cast<IndexType>(newIndex);
+        }
+        return nextVertex;
+    }
+
+    template VertexCacheStatistics analyzeVertexCache<uint16_t>(const uint16_t* const, const size_t, const size_t, const size_t);
+    template VertexCacheStatistics analyzeVertexCache<uint32_t>(const uint32_t* const, const size_t, const size_t, const size_t);
+    template void optimizeVertexCache<uint16_t>(uint16_t* const, const uint16_t* const, const size_t, const size_t);
+    template void optimizeVertexCache<uint32_t>(uint32_t* const, const uint32_t* const, const size_t, const size_t);
+    template size_t optimizeVertexFetch<uint16_t>(void* const, uint16_t* const, const size_t, const void* const, const size_t, const size_t);
+    template size_t optimizeVertexFetch<uint32_t>(void* const, uint32_t* const, const size_t, const void* const, const size_t, const size_t);
+}
\ No newline at end of file
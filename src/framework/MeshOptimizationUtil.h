@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cinttypes>
+#include <cstddef>
+
+// CPU passes that reorder indexed triangle lists for the GPU's post-transform vertex cache and vertex fetch. Results
+// are deterministic for a given input.
+namespace MeshOptimizationUtil
+{
+    struct VertexCacheStatistics
+    {
+        size_t transformedVertexCount;
+        // average cache miss ratio, transformed vertices per triangle. 0.5 is the lower bound for large regular meshes,
+        // 3.0 means no reuse at all
+        float acmr;
+        // average transformed vertex ratio, transformed vertices per referenced vertex. 1.0 is optimal
+        float atvr;
+    };
+
+    // simulates a FIFO post-transform cache with cacheSize entries
+    template <typename IndexType>
+    VertexCacheStatistics analyzeVertexCache(const IndexType* const indices, const size_t indexCount, const size_t vertexCount, const size_t cacheSize = 16u);
+
+    // Reorders the triangles of indices into destination with Tom Forsyth's linear-speed vertex cache optimization,
+    // which greedily emits the triangle whose vertices are most recently used or have the fewest remaining triangles.
+    // destination must not alias indices.
+    template <typename IndexType>
+    void optimizeVertexCache(IndexType* const destination, const IndexType* const indices, const size_t indexCount, const size_t vertexCount);
+
+    // Copies vertices into destinationVertices in the order the indices first reference them and remaps indices in
+    // place, so vertex fetch walks memory linearly. Unreferenced vertices are dropped, the returned count is the number
+    // of vertices written. destinationVertices must not alias vertices.
+    template <typename IndexType>
+    size_t optimizeVertexFetch(void* const destinationVertices, IndexType* const indices, const size_t indexCount, const void* const vertices, const size_t vertexCount, const size_t vertexSize);
+}
\ No newline at end of file
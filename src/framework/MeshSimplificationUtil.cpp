@@ -0,0 +1,361 @@
+#include "MeshSimplificationUtil.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include "ThreadUtil.h"
+#include "TriangleAdjacency.h"
+
+namespace
+{
+    // Sum of squared distances to planes, error(p) = p^T A p + 2 b^T p + c with the symmetric A stored as its upper
+    // triangle. Every plane is weighted by the area it stands for, so error / weight is a mean squared distance.
+    struct Quadric
+    {
+        float a00, a11, a22, a01, a02, a12;
+        float b0, b1, b2;
+        float c;
+        float weight;
+    };
+
+    void addPlaneQuadric(Quadric& quadric, DirectX::FXMVECTOR xmvNormal, const float distance, const float weight)
+    {
+        DirectX::XMFLOAT3 normal;
+        DirectX::XMStoreFloat3(&normal, xmvNormal);
+        quadric.a00 += weight * normal.x * normal.x;
+        quadric.a11 += weight * normal.y * normal.y;
+        quadric.a22 += weight * normal.z * normal.z;
+        quadric.a01 += weight * normal.x * normal.y;
+        quadric.a02 += weight * normal.x * normal.z;
+        quadric.a12 += weight * normal.y * normal.z;
+        quadric.b0 += weight * normal.x * distance;
+        quadric.b1 += weight * normal.y * distance;
+        quadric.b2 += weight * normal.z * distance;
+        quadric.c += weight * distance * distance;
+        quadric.weight += weight;
+    }
+
+    Quadric addQuadrics(const Quadric& q0, const Quadric& q1)
+    {
+        return {
+            q0.a00 + q1.a00, q0.a11 + q1.a11, q0.a22 + q1.a22, q0.a01 + q1.a01, q0.a02 + q1.a02, q0.a12 + q1.a12,
+            q0.b0 + q1.b0, q0.b1 + q1.b1, q0.b2 + q1.b2,
+            q0.c + q1.c,
+            q0.weight + q1.weight,
+        };
+    }
+
+    // mean squared distance of position to the planes of quadric
+    float evaluateQuadric(const Quadric& quadric, const DirectX::XMFLOAT3& position)
+    {
+        const float x = position.x;
+        const float y = position.y;
+        const float z = position.z;
+        const float error = quadric.a00 * x * x + quadric.a11 * y * y + quadric.a22 * z * z
+            + 2.0f * (quadric.a01 * x * y + quadric.a02 * x * z + quadric.a12 * y * z)
+            + 2.0f * (quadric.b0 * x + quadric.b1 * y + quadric.b2 * z)
+            + quadric.c;
+        // rounding can push errors of points on all planes slightly below 0
+        return quadric.weight > 0.0f ? std::fabs(error) / quadric.weight : std::fabs(error);
+    }
+
+    // weight of the planes that keep unlocked border vertices on the border, relative to the squared edge length
+    constexpr float borderWeight = 10.0f;
+
+    struct Collapse
+    {
+        uint32_t target;
+        float error;
+    };
+}
+
+namespace MeshSimplificationUtil
+{
+    template <typename IndexType>
+    size_t simplifyMesh(IndexType* const destination, const IndexType* const indices, const size_t indexCount, const void* const vertices, const size_t vertexCount,
+        const GeometryUtil::VertexDesc& vertexDesc, const size_t targetIndexCount, const float targetError, const bool lockBorder, float* const pResultError,
+        const size_t threadCount)
+    {
+        assert(indexCount % 3u == 0u);
+
+        std::vector<uint32_t> currentIndices(indices, indices + indexCount);
+        size_t currentIndexCount = indexCount;
+        const size_t workThreadCount = ThreadUtil::getThreadCount(vertexCount, threadCount);
+
+        // positions are moved into the unit cube, which makes errors relative to the largest extent of the mesh
+        std::vector<DirectX::XMFLOAT3> positions(vertexCount);
+        {
+            const uint8_t* const positionBytes = reinterpret_cast<const uint8_t*>(vertices) + GeometryUtil::findAttributeByteOffset(vertexDesc, GeometryUtil::VertexAttributeType::POSITION);
+            const auto loadPosition = [positionBytes, &vertexDesc](const size_t vertex)
+            {
+                return DirectX::XMLoadFloat3(reinterpret_cast<const DirectX::XMFLOAT3*>(positionBytes + vertex * vertexDesc.stride));
+            };
+
+            DirectX::XMVECTOR xmvMin = DirectX::XMVectorReplicate(std::numeric_limits<float>::max());
+            DirectX::XMVECTOR xmvMax = DirectX::XMVectorReplicate(-std::numeric_limits<float>::max());
+            for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+            {
+                xmvMin = DirectX::XMVectorMin(xmvMin, loadPosition(vertex));
+                xmvMax = DirectX::XMVectorMax(xmvMax, loadPosition(vertex));
+            }
+            DirectX::XMFLOAT3 extent;
+            DirectX::XMStoreFloat3(&extent, DirectX::XMVectorSubtract(xmvMax, xmvMin));
+            const float maxExtent = std::max(std::max(extent.x, extent.y), extent.z);
+            const float scale = maxExtent > 0.0f ? 1.0f / maxExtent : 1.0f;
+            for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+            {
+                DirectX::XMStoreFloat3(&positions[vertex], DirectX::XMVectorScale(DirectX::XMVectorSubtract(loadPosition(vertex), xmvMin), scale));
+            }
+        }
+
+        // triangles adjacent to each vertex, rebuilt after every pass of collapses
+        TriangleAdjacency adjacency;
+
+        // an edge is on the border if only one triangle uses it
+        const auto isBorderEdge = [&](const uint32_t vertex, const uint32_t otherVertex)
+        {
+            size_t triangleCount = 0;
+            const uint32_t* const vertexTriangles = adjacency.getTriangles(vertex);
+            for (uint32_t i = 0; i < adjacency.getTriangleCount(vertex); ++i)
+            {
+                const uint32_t* const triangleIndices = &currentIndices[vertexTriangles[i] * 3u];
+                triangleCount += (triangleIndices[0] == otherVertex || triangleIndices[1] == otherVertex || triangleIndices[2] == otherVertex) ? 1u : 0u;
+            }
+            return triangleCount == 1u;
+        };
+
+        const auto loadTriangleNormal = [&](const uint32_t* const triangleIndices)
+        {
+            const DirectX::XMVECTOR xmvPosition0 = DirectX::XMLoadFloat3(&positions[triangleIndices[0]]);
+            const DirectX::XMVECTOR xmvEdge0 = DirectX::XMVectorSubtract(DirectX::XMLoadFloat3(&positions[triangleIndices[1]]), xmvPosition0);
+            const DirectX::XMVECTOR xmvEdge1 = DirectX::XMVectorSubtract(DirectX::XMLoadFloat3(&positions[triangleIndices[2]]), xmvPosition0);
+            return DirectX::XMVector3Cross(xmvEdge0, xmvEdge1);
+        };
+
+        adjacency.build(currentIndices.data(), currentIndexCount, vertexCount);
+
+        std::vector<uint8_t> borderVertices(vertexCount, 0u);
+        std::vector<Quadric> quadrics(vertexCount);
+        ThreadUtil::parallelFor(vertexCount, [&](const size_t begin, const size_t end)
+        {
+            for (uint32_t vertex = static_cast<uint32_t>(begin); vertex < end; ++vertex)
+            {
+                Quadric quadric = {};
+                const uint32_t* const vertexTriangles = adjacency.getTriangles(vertex);
+                for (uint32_t i = 0; i < adjacency.getTriangleCount(vertex); ++i)
+                {
+                    const uint32_t* const triangleIndices = &currentIndices[vertexTriangles[i] * 3u];
+                    const DirectX::XMVECTOR xmvNormal = loadTriangleNormal(triangleIndices);
+                    const float normalLength = DirectX::XMVectorGetX(DirectX::XMVector3Length(xmvNormal));
+                    if (normalLength <= 0.0f)
+                    {
+                        continue;
+                    }
+
+                    const DirectX::XMVECTOR xmvUnitNormal = DirectX::XMVectorScale(xmvNormal, 1.0f / normalLength);
+                    const float distance = -DirectX::XMVectorGetX(DirectX::XMVector3Dot(xmvUnitNormal, DirectX::XMLoadFloat3(&positions[triangleIndices[0]])));
+                    addPlaneQuadric(quadric, xmvUnitNormal, distance, 0.5f * normalLength);
+
+                    for (size_t corner = 0; corner < 3u; ++corner)
+                    {
+                        if (triangleIndices[corner] == vertex)
+                        {
+                            continue;
+                        }
+
+                        const uint32_t otherVertex = triangleIndices[corner];
+                        if (!isBorderEdge(vertex, otherVertex))
+                        {
+                            continue;
+                        }
+                        borderVertices[vertex] = 1u;
+
+                        // plane through the border edge, perpendicular to its triangle
+                        const DirectX::XMVECTOR xmvPosition = DirectX::XMLoadFloat3(&positions[vertex]);
+                        const DirectX::XMVECTOR xmvEdge = DirectX::XMVectorSubtract(DirectX::XMLoadFloat3(&positions[otherVertex]), xmvPosition);
+                        const DirectX::XMVECTOR xmvBorderNormal = DirectX::XMVector3Cross(xmvEdge, xmvUnitNormal);
+                        const float borderNormalLength = DirectX::XMVectorGetX(DirectX::XMVector3Length(xmvBorderNormal));
+                        if (!lockBorder && borderNormalLength > 0.0f)
+                        {
+                            const DirectX::XMVECTOR xmvUnitBorderNormal = DirectX::XMVectorScale(xmvBorderNormal, 1.0f / borderNormalLength);
+                            const float borderDistance = -DirectX::XMVectorGetX(DirectX::XMVector3Dot(xmvUnitBorderNormal, xmvPosition));
+                            const float edgeLengthSquared = DirectX::XMVectorGetX(DirectX::XMVector3LengthSq(xmvEdge));
+                            addPlaneQuadric(quadric, xmvUnitBorderNormal, borderDistance, borderWeight * edgeLengthSquared);
+                        }
+                    }
+                }
+                quadrics[vertex] = quadric;
+            }
+        }, workThreadCount);
+
+        const float maxErrorSquared = targetError * targetError;
+        float resultErrorSquared = 0.0f;
+
+        std::vector<Collapse> collapses(vertexCount);
+        std::vector<uint32_t> collapseOrder;
+        std::vector<uint32_t> remap(vertexCount);
+        std::vector<uint8_t> touchedVertices(vertexCount);
+        while (currentIndexCount > targetIndexCount)
+        {
+            // cheapest collapse of every vertex onto one of its neighbours
+            ThreadUtil::parallelFor(vertexCount, [&](const size_t begin, const size_t end)
+            {
+                for (uint32_t vertex = static_cast<uint32_t>(begin); vertex < end; ++vertex)
+                {
+                    Collapse& collapse = collapses[vertex];
+                    collapse = { vertex, std::numeric_limits<float>::max() };
+                    if (lockBorder && borderVertices[vertex] != 0u)
+                    {
+                        continue;
+                    }
+
+                    const uint32_t* const vertexTriangles = adjacency.getTriangles(vertex);
+                    for (uint32_t i = 0; i < adjacency.getTriangleCount(vertex); ++i)
+                    {
+                        const uint32_t* const triangleIndices = &currentIndices[vertexTriangles[i] * 3u];
+                        for (size_t corner = 0; corner < 3u; ++corner)
+                        {
+                            const uint32_t target = triangleIndices[corner];
+                            if (target == vertex)
+                            {
+                                continue;
+                            }
+                            // border vertices stay on the border
+                            if (borderVertices[vertex] != 0u && !isBorderEdge(vertex, target))
+                            {
+                                continue;
+                            }
+
+                            const float error = evaluateQuadric(addQuadrics(quadrics[vertex], quadrics[target]), positions[target]);
+                            if (error < collapse.error || (error == collapse.error && target < collapse.target))
+                            {
+                                collapse = { target, error };
+                            }
+                        }
+                    }
+                }
+            }, workThreadCount);
+
+            collapseOrder.clear();
+            for (uint32_t vertex = 0; vertex < vertexCount; ++vertex)
+            {
+                if (collapses[vertex].target != vertex && collapses[vertex].error <= maxErrorSquared)
+                {
+                    collapseOrder.push_back(vertex);
+                }
+            }
+            std::sort(collapseOrder.begin(), collapseOrder.end(), [&collapses](const uint32_t vertex0, const uint32_t vertex1)
+            {
+                return collapses[vertex0].error < collapses[vertex1].error || (collapses[vertex0].error == collapses[vertex1].error && vertex0 < vertex1);
+            });
+
+            // Collapses are applied cheapest first. A collapse touches its vertex's triangles, which keeps the errors and
+            // flip checks of the remaining collapses of this pass exact as long as they do not touch them again.
+            std::iota(remap.begin(), remap.end(), 0u);
+            std::fill(touchedVertices.begin(), touchedVertices.end(), static_cast<uint8_t>(0u));
+            size_t remainingIndexCount = currentIndexCount;
+            size_t appliedCollapseCount = 0;
+            for (const uint32_t vertex : collapseOrder)
+            {
+                if (remainingIndexCount <= targetIndexCount)
+                {
+                    break;
+                }
+
+                const Collapse& collapse = collapses[vertex];
+                if (touchedVertices[vertex] != 0u || touchedVertices[collapse.target] != 0u)
+                {
+                    continue;
+                }
+
+                // triangles that keep their area must not turn around, triangles on the collapsed edge vanish
+                bool flipsTriangle = false;
+                size_t removedIndexCount = 0;
+                const uint32_t* const vertexTriangles = adjacency.getTriangles(vertex);
+                for (uint32_t i = 0; i < adjacency.getTriangleCount(vertex) && !flipsTriangle; ++i)
+                {
+                    const uint32_t* const triangleIndices = &currentIndices[vertexTriangles[i] * 3u];
+                    if (triangleIndices[0] == collapse.target || triangleIndices[1] == collapse.target || triangleIndices[2] == collapse.target)
+                    {
+                        removedIndexCount += 3u;
+                        continue;
+                    }
+
+                    const DirectX::XMVECTOR xmvNormal = loadTriangleNormal(triangleIndices);
+                    if (DirectX::XMVectorGetX(DirectX::XMVector3LengthSq(xmvNormal)) <= 0.0f)
+                    {
+                        continue;
+                    }
+
+                    uint32_t collapsedIndices[3];
+                    for (size_t corner = 0; corner < 3u; ++corner)
+                    {
+                        collapsedIndices[corner] = triangleIndices[corner] == vertex ? collapse.target : triangleIndices[corner];
+                    }
+                    const float normalDot = DirectX::XMVectorGetX(DirectX::XMVector3Dot(xmvNormal, loadTriangleNormal(collapsedIndices)));
+                    flipsTriangle = normalDot <= 0.0f;
+                }
+                if (flipsTriangle)
+                {
+                    continue;
+                }
+
+                remap[vertex] = collapse.target;
+                quadrics[collapse.target] = addQuadrics(quadrics[vertex], quadrics[collapse.target]);
+                resultErrorSquared = std::max(resultErrorSquared, collapse.error);
+                remainingIndexCount -= removedIndexCount;
+                ++appliedCollapseCount;
+
+                touchedVertices[collapse.target] = 1u;
+                for (uint32_t i = 0; i < adjacency.getTriangleCount(vertex); ++i)
+                {
+                    const uint32_t* const triangleIndices = &currentIndices[vertexTriangles[i] * 3u];
+                    touchedVertices[triangleIndices[0]] = 1u;
+                    touchedVertices[triangleIndices[1]] = 1u;
+                    touchedVertices[triangleIndices[2]] = 1u;
+                }
+            }
+
+            if (appliedCollapseCount == 0u)
+            {
+                break;
+            }
+
+            // drop the triangles that lost their area
+            size_t writtenIndexCount = 0;
+            for (size_t i = 0; i < currentIndexCount; i += 3u)
+            {
+                const uint32_t index0 = remap[currentIndices[i]];
+                const uint32_t index1 = remap[currentIndices[i + 1u]];
+                const uint32_t index2 = remap[currentIndices[i + 2u]];
+                if (index0 != index1 && index1 != index2 && index2 != index0)
+                {
+                    currentIndices[writtenIndexCount++] = index0;
+                    currentIndices[writtenIndexCount++] = index1;
+                    currentIndices[writtenIndexCount++] = index2;
+                }
+            }
+            currentIndexCount = writtenIndexCount;
+            adjacency.build(currentIndices.data(), currentIndexCount, vertexCount);
+        }
+
+        for (size_t i = 0; i < currentIndexCount; ++i)
+        {
+            destination[i] = static_cast<IndexType>(currentIndices[i]);
+        }
+        if (pResultError != nullptr)
+        {
+            *pResultError = std::sqrt(resultErrorSquared);
+        }
+        return currentIndexCount;
+    }
+
+    template size_t simplifyMesh<uint16_t>(uint16_t* const, const uint16_t* const, const size_t, const void* const, const size_t, const GeometryUtil::VertexDesc&, const size_t,
+        const float, const bool, float* const, const size_t);
+    template size_t simplifyMesh<uint32_t>(uint32_t* const, const uint32_t* const, const size_t, const void* const, const size_t, const GeometryUtil::VertexDesc&, const size_t,
+        const float, const bool, float* const, const size_t);
+}
\ No newline at end of file
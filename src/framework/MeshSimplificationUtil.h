@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cinttypes>
+#include <cstddef>
+
+#include "GeometryUtil.h"
+
+// Reduces the triangle count of indexed meshes by collapsing edges in the order of their quadric error. Vertices are
+// never moved or created, the simplified triangles index into the original vertex buffer, so any vertex layout works
+// and MeshOptimizationUtil::optimizeVertexFetch can drop the unused vertices afterwards.
+namespace MeshSimplificationUtil
+{
+    // Writes the simplified triangles to destination, which needs room for indexCount indices and may alias indices,
+    // and returns their index count. Simplification stops once the index count is at most targetIndexCount or the next
+    // collapse would move the surface further than targetError, given relative to the largest extent of the mesh. Pass
+    // a targetIndexCount of 0 to only bound the error, and a targetError of FLT_MAX to only bound the count.
+    // Positions are read from the float POSITION attribute of vertexDesc. Locked borders keep every vertex on an open
+    // edge, so tiles simplified on their own still fit together, otherwise border vertices only collapse along the
+    // border. pResultError receives the relative error of the result. Quadrics and collapse candidates are computed on
+    // multiple threads, a threadCount of 0 picks the thread count from the mesh size. The result does not depend on it.
+    template <typename IndexType>
+    size_t simplifyMesh(IndexType* const destination, const IndexType* const indices, const size_t indexCount, const void* const vertices, const size_t vertexCount,
+        const GeometryUtil::VertexDesc& vertexDesc, const size_t targetIndexCount, const float targetError, const bool lockBorder, float* const pResultError = nullptr,
+        const size_t threadCount = 0u);
+}
\ No newline at end of file
@@ -0,0 +1,309 @@
+#include "MeshletUtil.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+#include "TriangleAdjacency.h"
+
+namespace
+{
+    // Ritter's bounding sphere: starts with the two extreme points along the axis they are furthest apart on and grows
+    // the sphere to include every point outside of it
+    void computeBoundingSphere(const DirectX::XMFLOAT3* const positions, const size_t positionCount, DirectX::XMFLOAT3& center, float& radius)
+    {
+        const auto coordinate = [](const DirectX::XMFLOAT3& position, const size_t axis)
+        {
+            return axis == 0u ? position.x : axis == 1u ? position.y : position.z;
+        };
+
+        size_t minPoints[3] = { 0, 0, 0 };
+        size_t maxPoints[3] = { 0, 0, 0 };
+        for (size_t i = 1; i < positionCount; ++i)
+        {
+            for (size_t axis = 0; axis < 3u; ++axis)
+            {
+                if (coordinate(positions[i], axis) < coordinate(positions[minPoints[axis]], axis))
+                {
+                    minPoints[axis] = i;
+                }
+                if (coordinate(positions[i], axis) > coordinate(positions[maxPoints[axis]], axis))
+                {
+                    maxPoints[axis] = i;
+                }
+            }
+        }
+
+        DirectX::XMVECTOR xmvMin = DirectX::XMLoadFloat3(&positions[minPoints[0]]);
+        DirectX::XMVECTOR xmvMax = DirectX::XMLoadFloat3(&positions[maxPoints[0]]);
+        float maxDistanceSquared = DirectX::XMVectorGetX(DirectX::XMVector3LengthSq(DirectX::XMVectorSubtract(xmvMax, xmvMin)));
+        for (size_t axis = 1; axis < 3u; ++axis)
+        {
+            const DirectX::XMVECTOR xmvAxisMin = DirectX::XMLoadFloat3(&positions[minPoints[axis]]);
+            const DirectX::XMVECTOR xmvAxisMax = DirectX::XMLoadFloat3(&positions[maxPoints[axis]]);
+            const float distanceSquared = DirectX::XMVectorGetX(DirectX::XMVector3LengthSq(DirectX::XMVectorSubtract(xmvAxisMax, xmvAxisMin)));
+            if (distanceSquared > maxDistanceSquared)
+            {
+                xmvMin = xmvAxisMin;
+                xmvMax = xmvAxisMax;
+                maxDistanceSquared = distanceSquared;
+            }
+        }
+
+        DirectX::XMVECTOR xmvCenter = DirectX::XMVectorScale(DirectX::XMVectorAdd(xmvMin, xmvMax), 0.5f);
+        radius = 0.5f * std::sqrt(maxDistanceSquared);
+        for (size_t i = 0; i < positionCount; ++i)
+        {
+            const DirectX::XMVECTOR xmvPosition = DirectX::XMLoadFloat3(&positions[i]);
+            const float distance = DirectX::XMVectorGetX(DirectX::XMVector3Length(DirectX::XMVectorSubtract(xmvPosition, xmvCenter)));
+            if (distance > radius)
+            {
+                // move the center towards the point just far enough for the sphere to touch it
+                const float newRadius = 0.5f * (radius + distance);
+                xmvCenter = DirectX::XMVectorAdd(xmvCenter, DirectX::XMVectorScale(DirectX::XMVectorSubtract(xmvPosition, xmvCenter), (newRadius - radius) / distance));
+                radius = newRadius;
+            }
+        }
+        DirectX::XMStoreFloat3(&center, xmvCenter);
+    }
+
+    // the axis is the normalized average of the triangle normals and the cone is as wide as the normal furthest from it
+    void computeNormalCone(const DirectX::XMFLOAT3* const normals, const size_t normalCount, DirectX::XMFLOAT3& coneAxis, float& coneCutoff)
+    {
+        DirectX::XMVECTOR xmvNormalSum = DirectX::XMVectorZero();
+        for (size_t i = 0; i < normalCount; ++i)
+        {
+            xmvNormalSum = DirectX::XMVectorAdd(xmvNormalSum, DirectX::XMLoadFloat3(&normals[i]));
+        }
+
+        const float normalSumLength = DirectX::XMVectorGetX(DirectX::XMVector3Length(xmvNormalSum));
+        if (normalSumLength <= 0.0f)
+        {
+            coneAxis = { 0.0f, 0.0f, 0.0f };
+            coneCutoff = 1.0f;
+            return;
+        }
+
+        const DirectX::XMVECTOR xmvAxis = DirectX::XMVectorScale(xmvNormalSum, 1.0f / normalSumLength);
+        float minDot = 1.0f;
+        for (size_t i = 0; i < normalCount; ++i)
+        {
+            minDot = std::min(minDot, DirectX::XMVectorGetX(DirectX::XMVector3Dot(xmvAxis, DirectX::XMLoadFloat3(&normals[i]))));
+        }
+        DirectX::XMStoreFloat3(&coneAxis, xmvAxis);
+
+        // a view direction within 90 degrees minus the cone's half angle of the axis sees all triangles from behind,
+        // cos(90 - angle) = sin(angle). Cones of 90 degrees or more can not be culled.
+        coneCutoff = minDot > 0.0f ? std::sqrt(1.0f - minDot * minDot) : 1.0f;
+    }
+}
+
+namespace MeshletUtil
+{
+    template <typename IndexType>
+    void buildMeshlets(std::vector<Meshlet>& meshlets, std::vector<uint32_t>& meshletVertices, std::vector<uint8_t>& meshletTriangles,
+        const IndexType* const indices, const size_t indexCount, const void* const vertices, const size_t vertexCount, const GeometryUtil::VertexDesc& vertexDesc)
+    {
+        assert(indexCount % 3u == 0u);
+
+        meshlets.clear();
+        meshletVertices.clear();
+        meshletTriangles.clear();
+        meshletTriangles.reserve(indexCount);
+
+        const size_t triangleCount = indexCount / 3u;
+        const uint8_t* const positionBytes = reinterpret_cast<const uint8_t*>(vertices) + GeometryUtil::findAttributeByteOffset(vertexDesc, GeometryUtil::VertexAttributeType::POSITION);
+        const auto loadPosition = [positionBytes, &vertexDesc](const size_t vertex)
+        {
+            return DirectX::XMLoadFloat3(reinterpret_cast<const DirectX::XMFLOAT3*>(positionBytes + vertex * vertexDesc.stride));
+        };
+
+        TriangleAdjacency adjacency;
+        adjacency.build(indices, indexCount, vertexCount);
+
+        // candidates are compared by their center on every step
+        std::vector<DirectX::XMFLOAT3> triangleCenters(triangleCount);
+        for (size_t triangle = 0; triangle < triangleCount; ++triangle)
+        {
+            const IndexType* const triangleIndices = &indices[triangle * 3u];
+            const DirectX::XMVECTOR xmvPositionSum = DirectX::XMVectorAdd(DirectX::XMVectorAdd(
+                loadPosition(triangleIndices[0]), loadPosition(triangleIndices[1])), loadPosition(triangleIndices[2]));
+            DirectX::XMStoreFloat3(&triangleCenters[triangle], DirectX::XMVectorScale(xmvPositionSum, 1.0f / 3.0f));
+        }
+
+        std::vector<bool> emittedTriangles(triangleCount, false);
+        size_t inputCursor = 0;
+
+        // local index of every vertex in the current meshlet
+        constexpr uint8_t notInMeshlet = std::numeric_limits<uint8_t>::max();
+        std::vector<uint8_t> localIndices(vertexCount, notInMeshlet);
+
+        Meshlet meshlet = {};
+        DirectX::XMVECTOR xmvPositionSum = DirectX::XMVectorZero();
+        DirectX::XMFLOAT3 meshletPositions[maxMeshletVertexCount];
+        DirectX::XMFLOAT3 triangleNormals[maxMeshletTriangleCount];
+        size_t triangleNormalCount = 0;
+
+        const auto countNewVertices = [&](const size_t triangle)
+        {
+            const IndexType* const triangleIndices = &indices[triangle * 3u];
+            size_t newVertexCount = 0;
+            for (size_t corner = 0; corner < 3u; ++corner)
+            {
+                // degenerate triangles reference a vertex more than once
+                const bool repeated = (corner > 0u && triangleIndices[corner] == triangleIndices[0]) || (corner > 1u && triangleIndices[corner] == triangleIndices[1]);
+                newVertexCount += (localIndices[triangleIndices[corner]] == notInMeshlet && !repeated) ? 1u : 0u;
+            }
+            return newVertexCount;
+        };
+
+        const auto countMinLiveTriangles = [&](const size_t triangle)
+        {
+            const IndexType* const triangleIndices = &indices[triangle * 3u];
+            return std::min(std::min(adjacency.getLiveTriangleCount(triangleIndices[0]), adjacency.getLiveTriangleCount(triangleIndices[1])), adjacency.getLiveTriangleCount(triangleIndices[2]));
+        };
+
+        const auto finishMeshlet = [&]()
+        {
+            computeBoundingSphere(meshletPositions, meshlet.vertexCount, meshlet.center, meshlet.radius);
+            computeNormalCone(triangleNormals, triangleNormalCount, meshlet.coneAxis, meshlet.coneCutoff);
+            for (size_t i = 0; i < meshlet.vertexCount; ++i)
+            {
+                localIndices[meshletVertices[meshlet.vertexOffset + i]] = notInMeshlet;
+            }
+            meshlets.push_back(meshlet);
+
+            meshlet = {};
+            meshlet.vertexOffset = static_cast<uint32_t>(meshletVertices.size());
+            meshlet.triangleOffset = static_cast<uint32_t>(meshletTriangles.size());
+            xmvPositionSum = DirectX::XMVectorZero();
+            triangleNormalCount = 0;
+        };
+
+        constexpr size_t noTriangle = std::numeric_limits<size_t>::max();
+        size_t bestTriangle = noTriangle;
+        for (size_t emittedCount = 0; emittedCount < triangleCount; ++emittedCount)
+        {
+            if (bestTriangle == noTriangle)
+            {
+                // Nothing adjacent to the meshlet fits. The next one starts at the triangle along the finished
+                // meshlet's border with the fewest live neighbours, so no small islands of triangles are left behind.
+                if (meshlet.triangleCount > 0u)
+                {
+                    const Meshlet finishedMeshlet = meshlet;
+                    finishMeshlet();
+
+                    uint32_t bestMinLiveTriangleCount = std::numeric_limits<uint32_t>::max();
+                    for (size_t i = 0; i < finishedMeshlet.vertexCount; ++i)
+                    {
+                        const uint32_t vertex = meshletVertices[finishedMeshlet.vertexOffset + i];
+                        const uint32_t* const vertexTriangles = adjacency.getTriangles(vertex);
+                        for (uint32_t j = 0; j < adjacency.getLiveTriangleCount(vertex); ++j)
+                        {
+                            const uint32_t triangle = vertexTriangles[j];
+                            const uint32_t minLiveTriangleCount = countMinLiveTriangles(triangle);
+                            if (minLiveTriangleCount < bestMinLiveTriangleCount || (minLiveTriangleCount == bestMinLiveTriangleCount && triangle < bestTriangle))
+                            {
+                                bestTriangle = triangle;
+                                bestMinLiveTriangleCount = minLiveTriangleCount;
+                            }
+                        }
+                    }
+                }
+
+                // the finished meshlet was surrounded by emitted triangles, continue with the next one in input order
+                if (bestTriangle == noTriangle)
+                {
+                    while (emittedTriangles[inputCursor])
+                    {
+                        ++inputCursor;
+                    }
+                    bestTriangle = inputCursor;
+                }
+            }
+
+            const IndexType* const triangleIndices = &indices[bestTriangle * 3u];
+            for (size_t corner = 0; corner < 3u; ++corner)
+            {
+                const uint32_t vertex = triangleIndices[corner];
+                uint8_t& localIndex = localIndices[vertex];
+                if (localIndex == notInMeshlet)
+                {
+                    localIndex = static_cast<uint8_t>(meshlet.vertexCount);
+                    DirectX::XMStoreFloat3(&meshletPositions[meshlet.vertexCount], loadPosition(vertex));
+                    xmvPositionSum = DirectX::XMVectorAdd(xmvPositionSum, loadPosition(vertex));
+                    meshletVertices.push_back(vertex);
+                    ++meshlet.vertexCount;
+                }
+                meshletTriangles.push_back(localIndex);
+            }
+            ++meshlet.triangleCount;
+            emittedTriangles[bestTriangle] = true;
+            adjacency.removeTriangle(static_cast<uint32_t>(bestTriangle), triangleIndices);
+
+            {
+                const DirectX::XMVECTOR xmvPosition0 = loadPosition(triangleIndices[0]);
+                const DirectX::XMVECTOR xmvEdge0 = DirectX::XMVectorSubtract(loadPosition(triangleIndices[1]), xmvPosition0);
+                const DirectX::XMVECTOR xmvEdge1 = DirectX::XMVectorSubtract(loadPosition(triangleIndices[2]), xmvPosition0);
+                // front faces are clockwise in a right-handed space, see Meshlet
+                const DirectX::XMVECTOR xmvNormal = DirectX::XMVector3Cross(xmvEdge1, xmvEdge0);
+                // degenerate triangles have no facing
+                if (DirectX::XMVectorGetX(DirectX::XMVector3LengthSq(xmvNormal)) > 0.0f)
+                {
+                    DirectX::XMStoreFloat3(&triangleNormals[triangleNormalCount++], DirectX::XMVector3Normalize(xmvNormal));
+                }
+            }
+
+            bestTriangle = noTriangle;
+            if (meshlet.triangleCount == maxMeshletTriangleCount)
+            {
+                continue;
+            }
+
+            // Fewest new vertices first, then closest to the meshlet's center, then input order. Triangles that are the
+            // last live one of a vertex count as adding no vertices, otherwise they end up as small islands between
+            // meshlets.
+            const DirectX::XMVECTOR xmvMeshletCenter = DirectX::XMVectorScale(xmvPositionSum, 1.0f / static_cast<float>(meshlet.vertexCount));
+            size_t bestPriority = 4u;
+            float bestDistanceSquared = std::numeric_limits<float>::max();
+            for (size_t i = 0; i < meshlet.vertexCount; ++i)
+            {
+                const uint32_t vertex = meshletVertices[meshlet.vertexOffset + i];
+                const uint32_t* const vertexTriangles = adjacency.getTriangles(vertex);
+                for (uint32_t j = 0; j < adjacency.getLiveTriangleCount(vertex); ++j)
+                {
+                    const uint32_t triangle = vertexTriangles[j];
+                    const size_t newVertexCount = countNewVertices(triangle);
+                    if (meshlet.vertexCount + newVertexCount > maxMeshletVertexCount)
+                    {
+                        continue;
+                    }
+                    const size_t priority = countMinLiveTriangles(triangle) == 1u ? 0u : newVertexCount;
+                    if (priority > bestPriority)
+                    {
+                        continue;
+                    }
+
+                    const DirectX::XMVECTOR xmvTriangleCenter = DirectX::XMLoadFloat3(&triangleCenters[triangle]);
+                    const float distanceSquared = DirectX::XMVectorGetX(DirectX::XMVector3LengthSq(DirectX::XMVectorSubtract(xmvTriangleCenter, xmvMeshletCenter)));
+                    if (priority < bestPriority || distanceSquared < bestDistanceSquared ||
+                        (distanceSquared == bestDistanceSquared && triangle < bestTriangle))
+                    {
+                        bestTriangle = triangle;
+                        bestPriority = priority;
+                        bestDistanceSquared = distanceSquared;
+                    }
+                }
+            }
+        }
+
+        if (meshlet.triangleCount > 0u)
+        {
+            finishMeshlet();
+        }
+    }
+
+    template void buildMeshlets<uint16_t>(std::vector<Meshlet>&, std::vector<uint32_t>&, std::vector<uint8_t>&, const uint16_t* const, const size_t, const void* const, const size_t, const GeometryUtil::VertexDesc&);
+    template void buildMeshlets<uint32_t>(std::vector<Meshlet>&, std::vector<uint32_t>&, std::vector<uint8_t>&, const uint32_t* const, const size_t, const void* const, const size_t, const GeometryUtil::VertexDesc&);
+}
\ No newline at end of file
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cinttypes>
+#include <cstddef>
+#include <vector>
+
+#include "DirectXMath.h"
+
+#include "GeometryUtil.h"
+
+// Splits indexed triangle lists into meshlets, small clusters of triangles that mesh shaders or compute culling passes
+// process as a unit. Results are deterministic for a given input.
+namespace MeshletUtil
+{
+    // mesh shader friendly limits, the triangle count stays a multiple of 4 below NVIDIA's recommended 126 primitives
+    constexpr size_t maxMeshletVertexCount = 64u;
+    constexpr size_t maxMeshletTriangleCount = 124u;
+
+    struct Meshlet
+    {
+        // first entry in meshletVertices, which maps the local vertex indices of the meshlet to mesh vertices
+        uint32_t vertexOffset;
+        // first entry in meshletTriangles, which holds three local vertex indices per triangle
+        uint32_t triangleOffset;
+        uint32_t vertexCount;
+        uint32_t triangleCount;
+
+        // bounding sphere of the vertices
+        DirectX::XMFLOAT3 center;
+        float radius;
+        // normal cone of the triangles, seen from cameraPosition every triangle faces away if
+        // dot(center - cameraPosition, coneAxis) >= coneCutoff * length(center - cameraPosition) + radius.
+        // A coneCutoff of 1 means the triangles face too many directions for that to happen. Like the generators and
+        // the renderer, the cone takes clockwise triangles in a right-handed space as front facing, so the normal of
+        // triangle (p0, p1, p2) is cross(p2 - p0, p1 - p0).
+        DirectX::XMFLOAT3 coneAxis;
+        float coneCutoff;
+    };
+
+    // Greedily grows each meshlet by the adjacent triangle that adds the fewest new vertices, preferring triangles
+    // close to the meshlet's center, and starts a new one once nothing adjacent fits. Positions are read from the float
+    // POSITION attribute of vertexDesc. The output vectors are replaced.
+    template <typename IndexType>
+    void buildMeshlets(std::vector<Meshlet>& meshlets, std::vector<uint32_t>& meshletVertices, std::vector<uint8_t>& meshletTriangles,
+        const IndexType* const indices, const size_t indexCount, const void* const vertices, const size_t vertexCount, const GeometryUtil::VertexDesc& vertexDesc);
+
+    inline bool isMeshletBackFacing(const Meshlet& meshlet, DirectX::FXMVECTOR cameraPosition)
+    {
+        const DirectX::XMVECTOR toCenter = DirectX::XMVectorSubtract(DirectX::XMLoadFloat3(&meshlet.center), cameraPosition);
+        const float distance = DirectX::XMVectorGetX(DirectX::XMVector3Length(toCenter));
+        return DirectX::XMVectorGetX(DirectX::XMVector3Dot(toCenter, DirectX::XMLoadFloat3(&meshlet.coneAxis))) >= meshlet.coneCutoff * distance + meshlet.radius;
+    }
+}
\ No newline at end of file
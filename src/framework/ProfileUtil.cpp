@@ -0,0 +1,164 @@
+#include "ProfileUtil.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    static_assert((ProfileUtil::eventCapacityPerThread & (ProfileUtil::eventCapacityPerThread - 1u)) == 0u, "the ring buffers wrap with a mask");
+
+    struct ZoneEvent
+    {
+        const char* pName;
+        int64_t begin;
+        int64_t end;
+    };
+
+    // written by one thread at a time, eventCount only grows until clear
+    struct ThreadBuffer
+    {
+        std::unique_ptr<ZoneEvent[]> events = std::make_unique<ZoneEvent[]>(ProfileUtil::eventCapacityPerThread);
+        std::atomic<uint64_t> eventCount{ 0u };
+        bool isInUse = true;
+    };
+
+    std::mutex s_threadBuffersMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> s_threadBuffers;
+
+    // ThreadUtil::parallelFor starts new threads on every call, so buffers go back to the pool when their thread exits
+    struct ThreadBufferOwner
+    {
+        ThreadBuffer* pBuffer = nullptr;
+
+        ~ThreadBufferOwner()
+        {
+            if (pBuffer != nullptr)
+            {
+                const std::lock_guard<std::mutex> lock(s_threadBuffersMutex);
+                pBuffer->isInUse = false;
+            }
+        }
+    };
+
+    thread_local ThreadBufferOwner s_threadBufferOwner;
+
+    // only locks on the first zone of a thread
+    ThreadBuffer& acquireThreadBuffer()
+    {
+        const std::lock_guard<std::mutex> lock(s_threadBuffersMutex);
+        for (const std::unique_ptr<ThreadBuffer>& pBuffer : s_threadBuffers)
+        {
+            if (!pBuffer->isInUse)
+            {
+                pBuffer->isInUse = true;
+                return *pBuffer;
+            }
+        }
+        s_threadBuffers.push_back(std::make_unique<ThreadBuffer>());
+        return *s_threadBuffers.back();
+    }
+
+    void writeJsonString(std::ofstream& file, const char* pString)
+    {
+        file << '"';
+        for (; *pString != '\0'; ++pString)
+        {
+            if (*pString == '"' || *pString == '\\')
+            {
+                file << '\\';
+            }
+            file << *pString;
+        }
+        file << '"';
+    }
+
+    double ticksToMicroseconds(const int64_t ticks, const double microsecondsPerTick)
+    {
+        return static_cast<double>(ticks) * microsecondsPerTick;
+    }
+}
+
+namespace ProfileUtil
+{
+    namespace Detail
+    {
+        std::atomic<bool> s_enabled(false);
+
+        void recordZone(const char* const pName, const int64_t begin, const int64_t end)
+        {
+            if (s_threadBufferOwner.pBuffer == nullptr)
+            {
+                s_threadBufferOwner.pBuffer = &acquireThreadBuffer();
+            }
+            ThreadBuffer& buffer = *s_threadBufferOwner.pBuffer;
+
+            // the release store publishes the event to writeChromeTrace
+            const uint64_t eventCount = buffer.eventCount.load(std::memory_order_relaxed);
+            buffer.events[eventCount & (eventCapacityPerThread - 1u)] = { pName, begin, end };
+            buffer.eventCount.store(eventCount + 1u, std::memory_order_release);
+        }
+    }
+
+    void setEnabled(const bool enabled)
+    {
+        Detail::s_enabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    void clear()
+    {
+        const std::lock_guard<std::mutex> lock(s_threadBuffersMutex);
+        for (const std::unique_ptr<ThreadBuffer>& pBuffer : s_threadBuffers)
+        {
+            pBuffer->eventCount.store(0u, std::memory_order_relaxed);
+        }
+    }
+
+    bool writeChromeTrace(const std::filesystem::path& path)
+    {
+        const std::lock_guard<std::mutex> lock(s_threadBuffersMutex);
+
+        // the oldest event kept by each buffer, wrapped buffers lost the ones before
+        std::vector<std::pair<uint64_t, uint64_t>> eventRanges;
+        eventRanges.reserve(s_threadBuffers.size());
+        int64_t firstBegin = std::numeric_limits<int64_t>::max();
+        for (const std::unique_ptr<ThreadBuffer>& pBuffer : s_threadBuffers)
+        {
+            const uint64_t eventCount = pBuffer->eventCount.load(std::memory_order_acquire);
+            const uint64_t firstEvent = eventCount > eventCapacityPerThread ? eventCount - eventCapacityPerThread : 0u;
+            eventRanges.emplace_back(firstEvent, eventCount);
+            for (uint64_t event = firstEvent; event < eventCount; ++event)
+            {
+                firstBegin = std::min(firstBegin, pBuffer->events[event & (eventCapacityPerThread - 1u)].begin);
+            }
+        }
+
+        // timestamps in microseconds since the first zone, which keeps them short and precise
+        const double microsecondsPerTick = 1.0e6 / TimeUtil::getTicksPerSecond();
+        std::ofstream file(path, std::ios::trunc);
+        file << std::fixed << std::setprecision(3);
+        file << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+        bool isFirstEvent = true;
+        for (size_t bufferIndex = 0; bufferIndex < s_threadBuffers.size(); ++bufferIndex)
+        {
+            const ThreadBuffer& buffer = *s_threadBuffers[bufferIndex];
+            for (uint64_t event = eventRanges[bufferIndex].first; event < eventRanges[bufferIndex].second; ++event)
+            {
+                const ZoneEvent& zoneEvent = buffer.events[event & (eventCapacityPerThread - 1u)];
+                file << (isFirstEvent ? "\n" : ",\n") << "{\"name\": ";
+                writeJsonString(file, zoneEvent.pName);
+                file << ", \"cat\": \"cpu\", \"ph\": \"X\", \"ts\": " << ticksToMicroseconds(zoneEvent.begin - firstBegin, microsecondsPerTick)
+                    << ", \"dur\": " << ticksToMicroseconds(zoneEvent.end - zoneEvent.begin, microsecondsPerTick) << ", \"pid\": 1, \"tid\": " << bufferIndex << "}";
+                isFirstEvent = false;
+            }
+        }
+        file << "\n]}\n";
+        file.close();
+        return static_cast<bool>(file);
+    }
+}
\ No newline at end of file
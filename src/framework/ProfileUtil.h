@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <cinttypes>
+#include <cstddef>
+#include <filesystem>
+
+#include "TimeUtil.h"
+
+// Scoped CPU zones for hot paths, exported as Chrome trace JSON for chrome://tracing or ui.perfetto.dev. Every thread
+// records into its own ring buffer without locks, threads that exit hand their buffer to the next thread. Zones are
+// off until setEnabled(true), a disabled zone costs an atomic load and a branch. Defining PROFILER_DISABLED compiles
+// the zones out completely.
+namespace ProfileUtil
+{
+    // zones each thread keeps, older ones are overwritten
+    constexpr size_t eventCapacityPerThread = size_t(1u) << 16u;
+
+    void setEnabled(const bool enabled);
+
+    // Forgets all recorded zones. Writing the trace or clearing while other threads record may tear their latest
+    // zones, so call both from the main thread between frames or after joining the workers.
+    void clear();
+
+    // one complete event per zone, rows are the thread buffers
+    bool writeChromeTrace(const std::filesystem::path& path);
+
+    // implementation of Zone, inline so disabled zones stay cheap
+    namespace Detail
+    {
+        extern std::atomic<bool> s_enabled;
+
+        void recordZone(const char* const pName, const int64_t begin, const int64_t end);
+
+        // the default time source, usually the TSC
+        inline int64_t getTicks()
+        {
+            return TimeUtil::getTicks();
+        }
+    }
+
+    // records the time between construction and destruction, pName has to outlive the trace, e.g. a string literal
+    class Zone
+    {
+    public:
+        explicit Zone(const char* const pName) :
+            m_pName(Detail::s_enabled.load(std::memory_order_relaxed) ? pName : nullptr),
+            m_begin(m_pName != nullptr ? Detail::getTicks() : 0)
+        {}
+
+        ~Zone()
+        {
+            if (m_pName != nullptr)
+            {
+                Detail::recordZone(m_pName, m_begin, Detail::getTicks());
+            }
+        }
+
+        Zone(const Zone& other) = delete;
+        Zone& operator=(const Zone& other) = delete;
+    private:
+        const char* const m_pName;
+        const int64_t m_begin;
+    };
+}
+
+#define PROFILE_UTIL_CONCATENATE_IMPL(lhs, rhs) lhs##rhs
+#define PROFILE_UTIL_CONCATENATE(lhs, rhs) PROFILE_UTIL_CONCATENATE_IMPL(lhs, rhs)
+
+// PROFILE_ZONE("GeometryUtil::createSquare"); times the rest of the enclosing scope, names have to be string literals
+#if defined(PROFILER_DISABLED)
+#define PROFILE_ZONE(name) static_cast<void>(0)
+#else
+#define PROFILE_ZONE(name) const ProfileUtil::Zone PROFILE_UTIL_CONCATENATE(profileZone, __LINE__)("" name)
+#endif
\ No newline at end of file
@@ -0,0 +1,11 @@
+#include "ThreadUtil.h"
+
+namespace ThreadUtil
+{
+    size_t getDefaultThreadCount()
+    {
+        // hardware_concurrency may return 0 if the count is not computable
+        static const size_t threadCount = std::max(1u, std::thread::hardware_concurrency());
+        return threadCount;
+    }
+}
\ No newline at end of file
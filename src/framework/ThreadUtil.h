@@ -0,0 +1,61 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace ThreadUtil
+{
+    // hardware thread count, at least 1
+    size_t getDefaultThreadCount();
+
+    // The least work a thread should get, counted in vertices or items of similar cost. Starting a thread for less
+    // costs about as much as it saves.
+    constexpr size_t minWorkPerThread = size_t(1u) << 14u;
+
+    // threadCount if it is not 0, otherwise one thread per minWorkPerThread of workCount, at least 1 and at most
+    // getDefaultThreadCount()
+    inline size_t getThreadCount(const size_t workCount, const size_t threadCount = 0u)
+    {
+        return threadCount != 0u ? threadCount : std::clamp(workCount / minWorkPerThread, size_t(1u), getDefaultThreadCount());
+    }
+
+    // Splits [0, count) into contiguous ranges and calls func(begin, end) once per range on up to threadCount threads,
+    // one of which is the calling thread. A threadCount of 0 uses getDefaultThreadCount(). Returns once all ranges are
+    // done, so consecutive calls act as a barrier.
+    template <typename Func>
+    void parallelFor(const size_t count, const Func& func, size_t threadCount = 0u)
+    {
+        if (threadCount == 0u)
+        {
+            threadCount = getDefaultThreadCount();
+        }
+        threadCount = std::min(threadCount, count);
+
+        if (threadCount <= 1u)
+        {
+            if (count > 0u)
+            {
+                func(size_t(0u), count);
+            }
+            return;
+        }
+
+        std::vector<std::thread> threads;
+        threads.reserve(threadCount - 1u);
+        for (size_t threadIndex = 1u; threadIndex < threadCount; ++threadIndex)
+        {
+            const size_t begin = count * threadIndex / threadCount;
+            const size_t end = count * (threadIndex + 1u) / threadCount;
+            threads.emplace_back([&func, begin, end]() { func(begin, end); });
+        }
+
+        func(size_t(0u), count / threadCount);
+
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,133 @@
+#include "TimeUtil.h"
+
+#include <chrono>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include "windows.h"
+#else
+#include <time.h>
+#endif
+
+#if defined(TIME_UTIL_TSC) && !defined(_MSC_VER)
+#include <cpuid.h>
+#endif
+
+namespace
+{
+    bool detectInvariantTsc()
+    {
+#if defined(TIME_UTIL_TSC)
+        // CPUID leaf 0x80000007 reports the invariant TSC in bit 8 of EDX
+#if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, static_cast<int>(0x80000000u));
+        if (static_cast<unsigned int>(info[0]) < 0x80000007u)
+        {
+            return false;
+        }
+        __cpuid(info, static_cast<int>(0x80000007u));
+        return (info[3] & (1 << 8)) != 0;
+#else
+        unsigned int eax;
+        unsigned int ebx;
+        unsigned int ecx;
+        unsigned int edx;
+        if (__get_cpuid_max(0x80000000u, nullptr) < 0x80000007u || !__get_cpuid(0x80000007u, &eax, &ebx, &ecx, &edx))
+        {
+            return false;
+        }
+        return (edx & (1u << 8)) != 0u;
+#endif
+#else
+        return false;
+#endif
+    }
+
+    // long enough that the resolution and latency of steady_clock do not matter, short enough not to delay startup
+    double calibrateTscTicksPerSecond()
+    {
+        using clock_type = std::chrono::steady_clock;
+        constexpr std::chrono::milliseconds calibrationDuration(10);
+
+        const clock_type::time_point start = clock_type::now();
+        const int64_t tscStart = TimeUtil::readTscTicks();
+        clock_type::time_point end;
+        do
+        {
+            end = clock_type::now();
+        } while (end - start < calibrationDuration);
+        const int64_t tscEnd = TimeUtil::readTscTicks();
+
+        return static_cast<double>(tscEnd - tscStart) / std::chrono::duration<double>(end - start).count();
+    }
+
+    double getMonotonicTicksPerSecond()
+    {
+#if defined(_WIN32)
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
+        return static_cast<double>(frequency.QuadPart);
+#else
+        return 1.0e9;
+#endif
+    }
+}
+
+namespace TimeUtil
+{
+    bool isInvariantTscSupported()
+    {
+        static const bool isSupported = detectInvariantTsc();
+        return isSupported;
+    }
+
+    TimeSource getDefaultTimeSource()
+    {
+        static const TimeSource timeSource = isInvariantTscSupported() ? TimeSource::Tsc : TimeSource::Monotonic;
+        return timeSource;
+    }
+
+    double getTicksPerSecond(const TimeSource timeSource)
+    {
+        switch (timeSource)
+        {
+        case TimeSource::Tsc:
+        {
+#if defined(TIME_UTIL_TSC)
+            static const double tscTicksPerSecond = calibrateTscTicksPerSecond();
+            return tscTicksPerSecond;
+#else
+            return getTicksPerSecond(TimeSource::Monotonic);
+#endif
+        }
+        case TimeSource::Monotonic:
+        {
+            static const double monotonicTicksPerSecond = getMonotonicTicksPerSecond();
+            return monotonicTicksPerSecond;
+        }
+        default:
+            return static_cast<double>(std::chrono::steady_clock::period::den) / static_cast<double>(std::chrono::steady_clock::period::num);
+        }
+    }
+
+    int64_t readMonotonicTicks()
+    {
+#if defined(_WIN32)
+        LARGE_INTEGER counter;
+        QueryPerformanceCounter(&counter);
+        return static_cast<int64_t>(counter.QuadPart);
+#else
+        timespec time;
+        clock_gettime(CLOCK_MONOTONIC, &time);
+        return static_cast<int64_t>(time.tv_sec) * 1000000000 + static_cast<int64_t>(time.tv_nsec);
+#endif
+    }
+
+    int64_t readSteadyClockTicks()
+    {
+        return static_cast<int64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    }
+}
\ No newline at end of file
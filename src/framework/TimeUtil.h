@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cinttypes>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define TIME_UTIL_TSC 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+// Tick counters for Timer and the ProfileUtil zones. Reading the TSC takes a few nanoseconds, but it only measures
+// time on CPUs with an invariant TSC, and its rate has to be calibrated against steady_clock, which happens once on
+// first use. The monotonic clock, i.e. clock_gettime(CLOCK_MONOTONIC) or QueryPerformanceCounter, works everywhere and
+// is the fallback.
+namespace TimeUtil
+{
+    enum class TimeSource : uint8_t
+    {
+        Tsc,
+        Monotonic,
+        SteadyClock,
+    };
+
+    // whether the TSC runs at a constant rate in all power states, checked once
+    bool isInvariantTscSupported();
+
+    // Tsc if it is invariant and Monotonic otherwise, picked once
+    TimeSource getDefaultTimeSource();
+
+    double getTicksPerSecond(const TimeSource timeSource);
+
+    int64_t readMonotonicTicks();
+    int64_t readSteadyClockTicks();
+
+    // counts cycles of the TSC rate, not of the current CPU clock, on CPUs without a TSC it reads the monotonic clock
+    inline int64_t readTscTicks()
+    {
+#if defined(TIME_UTIL_TSC)
+        return static_cast<int64_t>(__rdtsc());
+#else
+        return readMonotonicTicks();
+#endif
+    }
+
+    inline int64_t getTicks(const TimeSource timeSource)
+    {
+        switch (timeSource)
+        {
+        case TimeSource::Tsc:
+            return readTscTicks();
+        case TimeSource::Monotonic:
+            return readMonotonicTicks();
+        default:
+            return readSteadyClockTicks();
+        }
+    }
+
+    // ticks of the default time source
+    inline int64_t getTicks()
+    {
+        return getTicks(getDefaultTimeSource());
+    }
+
+    inline double getTicksPerSecond()
+    {
+        return getTicksPerSecond(getDefaultTimeSource());
+    }
+}
\ No newline at end of file
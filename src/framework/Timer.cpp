@@ -1,10 +1,12 @@
 #include "Timer.h"
 
-Timer::Timer() :
-    m_baseTime(clock_type::now()),
-    m_prevTime(clock_type::now()),
-    m_curTime(clock_type::now()),
-    m_stopTime(clock_type::now()),
+Timer::Timer(const TimeUtil::TimeSource timeSource) :
+    m_timeSource(timeSource),
+    m_secondsPerTick(1.0 / TimeUtil::getTicksPerSecond(timeSource)),
+    m_baseTime(getTicks()),
+    m_prevTime(getTicks()),
+    m_curTime(getTicks()),
+    m_stopTime(getTicks()),
     m_pausedTime(0),
     m_delta(0.0f),
     m_stopped(true)
@@ -12,18 +14,18 @@ Timer::Timer() :
 
 void Timer::reset()
 {
-    m_baseTime = clock_type::now();
-    m_prevTime = clock_type::now();
-    m_curTime = clock_type::now();
-    m_stopTime = clock_type::now();
-    m_pausedTime = duration(0);
+    m_baseTime = getTicks();
+    m_prevTime = getTicks();
+    m_curTime = getTicks();
+    m_stopTime = getTicks();
+    m_pausedTime = 0;
     m_delta = 0.0f;
 }
 
 void Timer::tick()
 {
-    m_curTime = clock_type::now();
-    m_delta = std::chrono::duration<float>(m_curTime - m_prevTime).count();
+    m_curTime = getTicks();
+    m_delta = static_cast<float>(static_cast<double>(m_curTime - m_prevTime) * m_secondsPerTick);
     m_prevTime = m_curTime;
 }
 
@@ -31,7 +33,7 @@ void Timer::stop()
 {
     if (!m_stopped)
     {
-        m_stopTime = clock_type::now();
+        m_stopTime = getTicks();
         m_stopped = true;
     }
 }
@@ -40,7 +42,7 @@ void Timer::start()
 {
     if (m_stopped)
     {
-        time_point startTime = clock_type::now();
+        int64_t startTime = getTicks();
         m_prevTime = startTime;
         m_pausedTime += startTime - m_stopTime;
         m_stopped = false;
@@ -56,10 +58,15 @@ float Timer::getElapsedTime() const
 {
     if (m_stopped)
     {
-        return std::chrono::duration<float>((m_stopTime - m_baseTime) - m_pausedTime).count();
+        return static_cast<float>(static_cast<double>((m_stopTime - m_baseTime) - m_pausedTime) * m_secondsPerTick);
     }
     else
     {
-        return std::chrono::duration<float>((m_curTime - m_baseTime) - m_pausedTime).count();
+        return static_cast<float>(static_cast<double>((m_curTime - m_baseTime) - m_pausedTime) * m_secondsPerTick);
     }
 }
+
+int64_t Timer::getTicks() const
+{
+    return TimeUtil::getTicks(m_timeSource);
+}
@@ -1,11 +1,14 @@
 #pragma once
 
-#include <chrono>
+#include <cinttypes>
+
+#include "TimeUtil.h"
 
 class Timer
 {
 public:
-    Timer();
+    // the default time source is the invariant TSC where available, see TimeUtil
+    explicit Timer(const TimeUtil::TimeSource timeSource = TimeUtil::getDefaultTimeSource());
 
     void reset();
     void tick();
@@ -14,15 +17,16 @@ public:
     float getDelta() const;
     float getElapsedTime() const;
 private:
-    using clock_type = std::chrono::high_resolution_clock;
-    using time_point = std::chrono::time_point<clock_type>;
-    using duration = clock_type::duration;
+    int64_t getTicks() const;
 
-    time_point m_baseTime;
-    time_point m_prevTime;
-    time_point m_curTime;
-    time_point m_stopTime;
-    duration m_pausedTime;
+    TimeUtil::TimeSource m_timeSource;
+    // cached so tick only reads the source and multiplies
+    double m_secondsPerTick;
+    int64_t m_baseTime;
+    int64_t m_prevTime;
+    int64_t m_curTime;
+    int64_t m_stopTime;
+    int64_t m_pausedTime;
     float m_delta;
     bool m_stopped;
-};
\ No newline at end of file
+};
@@ -0,0 +1,374 @@
+#include "TransformUtil.h"
+
+#include "ThreadUtil.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define TRANSFORM_UTIL_AVX2 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+// MSVC allows AVX2 intrinsics in any function
+#define TRANSFORM_UTIL_AVX2_TARGET
+#else
+// GCC and Clang only allow them in functions compiled for AVX2, so the rest of the build keeps running on any x64 CPU
+#define TRANSFORM_UTIL_AVX2_TARGET __attribute__((target("avx2,fma")))
+#endif
+#endif
+
+namespace
+{
+    // work of one matrix product in points, for ThreadUtil::getThreadCount
+    constexpr size_t matrixWork = 4u;
+
+    void multiplyMatricesFallback(DirectX::XMFLOAT4X4* const dst, const DirectX::XMFLOAT4X4* const lhs, const DirectX::XMFLOAT4X4* const rhs, const size_t rhsStep,
+        const size_t begin, const size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            const DirectX::XMMATRIX xmLhs = DirectX::XMLoadFloat4x4(&lhs[i]);
+            const DirectX::XMMATRIX xmRhs = DirectX::XMLoadFloat4x4(&rhs[i * rhsStep]);
+            DirectX::XMStoreFloat4x4(&dst[i], DirectX::XMMatrixMultiply(xmLhs, xmRhs));
+        }
+    }
+
+    void inverseTransposeMatricesFallback(DirectX::XMFLOAT4X4* const dst, const DirectX::XMFLOAT4X4* const src, const size_t begin, const size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            const DirectX::XMMATRIX xmMatrix = DirectX::XMLoadFloat4x4(&src[i]);
+            DirectX::XMStoreFloat4x4(&dst[i], DirectX::XMMatrixTranspose(DirectX::XMMatrixInverse(nullptr, xmMatrix)));
+        }
+    }
+
+    void transformVectorsFallback(DirectX::XMFLOAT3* const dst, const DirectX::XMFLOAT3* const src, const DirectX::XMFLOAT4X4& matrix, const bool translate,
+        const size_t begin, const size_t end)
+    {
+        const DirectX::XMMATRIX xmMatrix = DirectX::XMLoadFloat4x4(&matrix);
+        for (size_t i = begin; i < end; ++i)
+        {
+            const DirectX::XMVECTOR xmvSrc = DirectX::XMLoadFloat3(&src[i]);
+            DirectX::XMStoreFloat3(&dst[i], translate ? DirectX::XMVector3Transform(xmvSrc, xmMatrix) : DirectX::XMVector3TransformNormal(xmvSrc, xmMatrix));
+        }
+    }
+
+#if defined(TRANSFORM_UTIL_AVX2)
+    bool detectAvx2()
+    {
+#if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7)
+        {
+            return false;
+        }
+        // FMA, AVX and the OS saving the AVX registers on context switches
+        __cpuid(info, 1);
+        const int fmaAvxOsxsaveBits = (1 << 12) | (1 << 27) | (1 << 28);
+        if ((info[2] & fmaAvxOsxsaveBits) != fmaAvxOsxsaveBits || (_xgetbv(0) & 6u) != 6u)
+        {
+            return false;
+        }
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        // also checks that the OS saves the AVX registers
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+    }
+
+    // Matrices are processed in pairs, one per 128 bit lane, since every row of a 4x4 float matrix fills a lane and the
+    // constant buffers want them row by row anyway. All shuffles stay within lanes, so the two matrices never mix.
+
+    // rows[r] holds row r of matrices[0] in the low lane and of matrices[1] in the high lane
+    TRANSFORM_UTIL_AVX2_TARGET inline void loadMatrixPair(const DirectX::XMFLOAT4X4* const matrices, __m256 rows[4])
+    {
+        const float* const pFloats = &matrices[0].m[0][0];
+        const __m256 first01 = _mm256_loadu_ps(pFloats);
+        const __m256 first23 = _mm256_loadu_ps(pFloats + 8);
+        const __m256 second01 = _mm256_loadu_ps(pFloats + 16);
+        const __m256 second23 = _mm256_loadu_ps(pFloats + 24);
+        rows[0] = _mm256_permute2f128_ps(first01, second01, 0x20);
+        rows[1] = _mm256_permute2f128_ps(first01, second01, 0x31);
+        rows[2] = _mm256_permute2f128_ps(first23, second23, 0x20);
+        rows[3] = _mm256_permute2f128_ps(first23, second23, 0x31);
+    }
+
+    TRANSFORM_UTIL_AVX2_TARGET inline void storeMatrixPair(DirectX::XMFLOAT4X4* const matrices, const __m256 rows[4])
+    {
+        float* const pFloats = &matrices[0].m[0][0];
+        _mm256_storeu_ps(pFloats, _mm256_permute2f128_ps(rows[0], rows[1], 0x20));
+        _mm256_storeu_ps(pFloats + 8, _mm256_permute2f128_ps(rows[2], rows[3], 0x20));
+        _mm256_storeu_ps(pFloats + 16, _mm256_permute2f128_ps(rows[0], rows[1], 0x31));
+        _mm256_storeu_ps(pFloats + 24, _mm256_permute2f128_ps(rows[2], rows[3], 0x31));
+    }
+
+    // row of the product as linear combination of the rows of rhs
+    TRANSFORM_UTIL_AVX2_TARGET inline __m256 multiplyRow(const __m256 lhsRow, const __m256 rhsRows[4])
+    {
+        __m256 row = _mm256_mul_ps(_mm256_permute_ps(lhsRow, 0x00), rhsRows[0]);
+        row = _mm256_fmadd_ps(_mm256_permute_ps(lhsRow, 0x55), rhsRows[1], row);
+        row = _mm256_fmadd_ps(_mm256_permute_ps(lhsRow, 0xAA), rhsRows[2], row);
+        return _mm256_fmadd_ps(_mm256_permute_ps(lhsRow, 0xFF), rhsRows[3], row);
+    }
+
+    TRANSFORM_UTIL_AVX2_TARGET void multiplyMatricesAvx2(DirectX::XMFLOAT4X4* const dst, const DirectX::XMFLOAT4X4* const lhs, const DirectX::XMFLOAT4X4* const rhs, const size_t rhsStep,
+        const size_t begin, const size_t end)
+    {
+        // a shared rhs is loaded into both lanes once
+        __m256 rhsRows[4];
+        if (rhsStep == 0u)
+        {
+            for (size_t row = 0; row < 4u; ++row)
+            {
+                const __m128 rhsRow = _mm_loadu_ps(rhs->m[row]);
+                rhsRows[row] = _mm256_insertf128_ps(_mm256_castps128_ps256(rhsRow), rhsRow, 1);
+            }
+        }
+
+        size_t i = begin;
+        for (; i + 2u <= end; i += 2u)
+        {
+            __m256 lhsRows[4];
+            loadMatrixPair(&lhs[i], lhsRows);
+            if (rhsStep != 0u)
+            {
+                loadMatrixPair(&rhs[i], rhsRows);
+            }
+
+            __m256 rows[4];
+            for (size_t row = 0; row < 4u; ++row)
+            {
+                rows[row] = multiplyRow(lhsRows[row], rhsRows);
+            }
+            storeMatrixPair(&dst[i], rows);
+        }
+        multiplyMatricesFallback(dst, lhs, rhs, rhsStep, i, end);
+    }
+
+    // products of 2x2 matrices stored row by row in each lane, adj(a) is the adjugate of a
+    TRANSFORM_UTIL_AVX2_TARGET inline __m256 multiply2x2(const __m256 a, const __m256 b)
+    {
+        return _mm256_fmadd_ps(a, _mm256_permute_ps(b, _MM_SHUFFLE(3, 0, 3, 0)), _mm256_mul_ps(_mm256_permute_ps(a, _MM_SHUFFLE(2, 3, 0, 1)), _mm256_permute_ps(b, _MM_SHUFFLE(1, 2, 1, 2))));
+    }
+
+    // adj(a) * b
+    TRANSFORM_UTIL_AVX2_TARGET inline __m256 adjugateMultiply2x2(const __m256 a, const __m256 b)
+    {
+        return _mm256_fmsub_ps(_mm256_permute_ps(a, _MM_SHUFFLE(0, 0, 3, 3)), b, _mm256_mul_ps(_mm256_permute_ps(a, _MM_SHUFFLE(2, 2, 1, 1)), _mm256_permute_ps(b, _MM_SHUFFLE(1, 0, 3, 2))));
+    }
+
+    // a * adj(b)
+    TRANSFORM_UTIL_AVX2_TARGET inline __m256 multiplyAdjugate2x2(const __m256 a, const __m256 b)
+    {
+        return _mm256_fmsub_ps(a, _mm256_permute_ps(b, _MM_SHUFFLE(0, 3, 0, 3)), _mm256_mul_ps(_mm256_permute_ps(a, _MM_SHUFFLE(2, 3, 0, 1)), _mm256_permute_ps(b, _MM_SHUFFLE(1, 2, 1, 2))));
+    }
+
+    // Inverts with the 2x2 blocks | A B | of the matrix, which only needs 2x2 adjugates: |M| = |A||D| + |B||C| - tr(adj(A)B adj(D)C)
+    //                             | C D |
+    // and M^-1 = 1 / |M| * | adj(X) adj(Y) | with X = |D|A - B adj(D)C, Y = |B|C - D adj(adj(A)B), Z = |C|B - A adj(adj(D)C)
+    //                      | adj(Z) adj(W) |
+    // and W = |A|D - C adj(A)B. The transpose is folded into the final shuffles.
+    TRANSFORM_UTIL_AVX2_TARGET void inverseTransposeMatricesAvx2(DirectX::XMFLOAT4X4* const dst, const DirectX::XMFLOAT4X4* const src, const size_t begin, const size_t end)
+    {
+        const __m256 adjugateSigns = _mm256_setr_ps(1.0f, -1.0f, -1.0f, 1.0f, 1.0f, -1.0f, -1.0f, 1.0f);
+
+        size_t i = begin;
+        for (; i + 2u <= end; i += 2u)
+        {
+            __m256 rows[4];
+            loadMatrixPair(&src[i], rows);
+
+            const __m256 a = _mm256_castpd_ps(_mm256_unpacklo_pd(_mm256_castps_pd(rows[0]), _mm256_castps_pd(rows[1])));
+            const __m256 b = _mm256_castpd_ps(_mm256_unpackhi_pd(_mm256_castps_pd(rows[0]), _mm256_castps_pd(rows[1])));
+            const __m256 c = _mm256_castpd_ps(_mm256_unpacklo_pd(_mm256_castps_pd(rows[2]), _mm256_castps_pd(rows[3])));
+            const __m256 d = _mm256_castpd_ps(_mm256_unpackhi_pd(_mm256_castps_pd(rows[2]), _mm256_castps_pd(rows[3])));
+
+            // |A|, |B|, |C| and |D| in each lane
+            const __m256 blockDets = _mm256_fmsub_ps(_mm256_shuffle_ps(rows[0], rows[2], _MM_SHUFFLE(2, 0, 2, 0)), _mm256_shuffle_ps(rows[1], rows[3], _MM_SHUFFLE(3, 1, 3, 1)),
+                _mm256_mul_ps(_mm256_shuffle_ps(rows[0], rows[2], _MM_SHUFFLE(3, 1, 3, 1)), _mm256_shuffle_ps(rows[1], rows[3], _MM_SHUFFLE(2, 0, 2, 0))));
+            const __m256 detA = _mm256_permute_ps(blockDets, 0x00);
+            const __m256 detB = _mm256_permute_ps(blockDets, 0x55);
+            const __m256 detC = _mm256_permute_ps(blockDets, 0xAA);
+            const __m256 detD = _mm256_permute_ps(blockDets, 0xFF);
+
+            const __m256 adjAB = adjugateMultiply2x2(a, b);
+            const __m256 adjDC = adjugateMultiply2x2(d, c);
+            __m256 x = _mm256_fmsub_ps(detD, a, multiply2x2(b, adjDC));
+            __m256 y = _mm256_fmsub_ps(detB, c, multiplyAdjugate2x2(d, adjAB));
+            __m256 z = _mm256_fmsub_ps(detC, b, multiplyAdjugate2x2(a, adjDC));
+            __m256 w = _mm256_fmsub_ps(detA, d, multiply2x2(c, adjAB));
+
+            // the trace of the product as dot product, summed across each lane
+            __m256 trace = _mm256_mul_ps(adjAB, _mm256_permute_ps(adjDC, _MM_SHUFFLE(3, 1, 2, 0)));
+            trace = _mm256_add_ps(trace, _mm256_permute_ps(trace, _MM_SHUFFLE(1, 0, 3, 2)));
+            trace = _mm256_add_ps(trace, _mm256_permute_ps(trace, _MM_SHUFFLE(2, 3, 0, 1)));
+            const __m256 det = _mm256_sub_ps(_mm256_fmadd_ps(detA, detD, _mm256_mul_ps(detB, detC)), trace);
+
+            // the signs of the 2x2 adjugates, the swaps happen in the shuffles below
+            const __m256 scale = _mm256_div_ps(adjugateSigns, det);
+            x = _mm256_mul_ps(x, scale);
+            y = _mm256_mul_ps(y, scale);
+            z = _mm256_mul_ps(z, scale);
+            w = _mm256_mul_ps(w, scale);
+
+            // rows of the inverse would be (x3, x1, y3, y1), (x2, x0, y2, y0), (z3, z1, w3, w1) and (z2, z0, w2, w0)
+            rows[0] = _mm256_shuffle_ps(x, z, _MM_SHUFFLE(2, 3, 2, 3));
+            rows[1] = _mm256_shuffle_ps(x, z, _MM_SHUFFLE(0, 1, 0, 1));
+            rows[2] = _mm256_shuffle_ps(y, w, _MM_SHUFFLE(2, 3, 2, 3));
+            rows[3] = _mm256_shuffle_ps(y, w, _MM_SHUFFLE(0, 1, 0, 1));
+            storeMatrixPair(&dst[i], rows);
+        }
+        inverseTransposeMatricesFallback(dst, src, i, end);
+    }
+
+    // Eight vectors are deinterleaved into one register per component, four per lane. Within a lane the 12 floats
+    // a, b and c hold (x0 y0 z0 x1), (y1 z1 x2 y2) and (z2 x3 y3 z3).
+    TRANSFORM_UTIL_AVX2_TARGET inline void loadVectors(const DirectX::XMFLOAT3* const vectors, __m256& x, __m256& y, __m256& z)
+    {
+        const float* const pFloats = &vectors[0].x;
+        const __m256 a = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(pFloats)), _mm_loadu_ps(pFloats + 12), 1);
+        const __m256 b = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(pFloats + 4)), _mm_loadu_ps(pFloats + 16), 1);
+        const __m256 c = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(pFloats + 8)), _mm_loadu_ps(pFloats + 20), 1);
+
+        const __m256 x2y2 = _mm256_shuffle_ps(b, c, _MM_SHUFFLE(2, 1, 3, 2));
+        const __m256 y0z0 = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 2, 1));
+        x = _mm256_shuffle_ps(a, x2y2, _MM_SHUFFLE(2, 0, 3, 0));
+        y = _mm256_shuffle_ps(y0z0, x2y2, _MM_SHUFFLE(3, 1, 2, 0));
+        z = _mm256_shuffle_ps(y0z0, c, _MM_SHUFFLE(3, 0, 3, 1));
+    }
+
+    TRANSFORM_UTIL_AVX2_TARGET inline void storeVectors(DirectX::XMFLOAT3* const vectors, const __m256 x, const __m256 y, const __m256 z)
+    {
+        const __m256 a = _mm256_shuffle_ps(_mm256_shuffle_ps(x, y, _MM_SHUFFLE(1, 0, 1, 0)), _mm256_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+        const __m256 b = _mm256_shuffle_ps(_mm256_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1)), _mm256_shuffle_ps(x, y, _MM_SHUFFLE(2, 2, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0));
+        const __m256 c = _mm256_shuffle_ps(_mm256_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2)), _mm256_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+
+        float* const pFloats = &vectors[0].x;
+        _mm_storeu_ps(pFloats, _mm256_castps256_ps128(a));
+        _mm_storeu_ps(pFloats + 4, _mm256_castps256_ps128(b));
+        _mm_storeu_ps(pFloats + 8, _mm256_castps256_ps128(c));
+        _mm_storeu_ps(pFloats + 12, _mm256_extractf128_ps(a, 1));
+        _mm_storeu_ps(pFloats + 16, _mm256_extractf128_ps(b, 1));
+        _mm_storeu_ps(pFloats + 20, _mm256_extractf128_ps(c, 1));
+    }
+
+    TRANSFORM_UTIL_AVX2_TARGET void transformVectorsAvx2(DirectX::XMFLOAT3* const dst, const DirectX::XMFLOAT3* const src, const DirectX::XMFLOAT4X4& matrix, const bool translate,
+        const size_t begin, const size_t end)
+    {
+        // one register per matrix element, the vectors are in structure of arrays form
+        __m256 elements[4][3];
+        for (size_t row = 0; row < 4u; ++row)
+        {
+            for (size_t col = 0; col < 3u; ++col)
+            {
+                elements[row][col] = _mm256_set1_ps(translate || row < 3u ? matrix.m[row][col] : 0.0f);
+            }
+        }
+
+        size_t i = begin;
+        for (; i + 8u <= end; i += 8u)
+        {
+            __m256 x;
+            __m256 y;
+            __m256 z;
+            loadVectors(&src[i], x, y, z);
+
+            __m256 components[3];
+            for (size_t col = 0; col < 3u; ++col)
+            {
+                components[col] = _mm256_fmadd_ps(x, elements[0][col], _mm256_fmadd_ps(y, elements[1][col], _mm256_fmadd_ps(z, elements[2][col], elements[3][col])));
+            }
+            storeVectors(&dst[i], components[0], components[1], components[2]);
+        }
+        transformVectorsFallback(dst, src, matrix, translate, i, end);
+    }
+#endif
+}
+
+namespace TransformUtil
+{
+    bool isAvx2Supported()
+    {
+#if defined(TRANSFORM_UTIL_AVX2)
+        static const bool avx2Supported = detectAvx2();
+        return avx2Supported;
+#else
+        return false;
+#endif
+    }
+
+    void multiplyMatrices(DirectX::XMFLOAT4X4* const dst, const DirectX::XMFLOAT4X4* const lhs, const DirectX::XMFLOAT4X4* const rhs, const size_t count, const size_t threadCount)
+    {
+        ThreadUtil::parallelFor(count, [&](const size_t begin, const size_t end)
+        {
+#if defined(TRANSFORM_UTIL_AVX2)
+            if (isAvx2Supported())
+            {
+                multiplyMatricesAvx2(dst, lhs, rhs, 1u, begin, end);
+                return;
+            }
+#endif
+            multiplyMatricesFallback(dst, lhs, rhs, 1u, begin, end);
+        }, ThreadUtil::getThreadCount(count * matrixWork, threadCount));
+    }
+
+    void multiplyMatrices(DirectX::XMFLOAT4X4* const dst, const DirectX::XMFLOAT4X4* const lhs, const DirectX::XMFLOAT4X4& rhs, const size_t count, const size_t threadCount)
+    {
+        ThreadUtil::parallelFor(count, [&](const size_t begin, const size_t end)
+        {
+#if defined(TRANSFORM_UTIL_AVX2)
+            if (isAvx2Supported())
+            {
+                multiplyMatricesAvx2(dst, lhs, &rhs, 0u, begin, end);
+                return;
+            }
+#endif
+            multiplyMatricesFallback(dst, lhs, &rhs, 0u, begin, end);
+        }, ThreadUtil::getThreadCount(count * matrixWork, threadCount));
+    }
+
+    void inverseTransposeMatrices(DirectX::XMFLOAT4X4* const dst, const DirectX::XMFLOAT4X4* const src, const size_t count, const size_t threadCount)
+    {
+        ThreadUtil::parallelFor(count, [&](const size_t begin, const size_t end)
+        {
+#if defined(TRANSFORM_UTIL_AVX2)
+            if (isAvx2Supported())
+            {
+                inverseTransposeMatricesAvx2(dst, src, begin, end);
+                return;
+            }
+#endif
+            inverseTransposeMatricesFallback(dst, src, begin, end);
+        }, ThreadUtil::getThreadCount(count * matrixWork, threadCount));
+    }
+
+    void transformPoints(DirectX::XMFLOAT3* const dst, const DirectX::XMFLOAT3* const src, const size_t count, const DirectX::XMFLOAT4X4& matrix, const size_t threadCount)
+    {
+        ThreadUtil::parallelFor(count, [&](const size_t begin, const size_t end)
+        {
+#if defined(TRANSFORM_UTIL_AVX2)
+            if (isAvx2Supported())
+            {
+                transformVectorsAvx2(dst, src, matrix, true, begin, end);
+                return;
+            }
+#endif
+            transformVectorsFallback(dst, src, matrix, true, begin, end);
+        }, ThreadUtil::getThreadCount(count, threadCount));
+    }
+
+    void transformNormals(DirectX::XMFLOAT3* const dst, const DirectX::XMFLOAT3* const src, const size_t count, const DirectX::XMFLOAT4X4& matrix, const size_t threadCount)
+    {
+        ThreadUtil::parallelFor(count, [&](const size_t begin, const size_t end)
+        {
+#if defined(TRANSFORM_UTIL_AVX2)
+            if (isAvx2Supported())
+            {
+                transformVectorsAvx2(dst, src, matrix, false, begin, end);
+                return;
+            }
+#endif
+            transformVectorsFallback(dst, src, matrix, false, begin, end);
+        }, ThreadUtil::getThreadCount(count, threadCount));
+    }
+}
\ No newline at end of file
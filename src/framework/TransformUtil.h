@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+
+#include "DirectXMath.h"
+
+// Batched versions of the DirectXMath transforms for arrays of matrices, points and normals, e.g. world matrices of
+// many objects or the vertices of dynamic meshes. Results match the DirectXMath functions named on each up to
+// rounding. CPUs with AVX2 and FMA process eight points or two matrices per instruction, others and the remainder of
+// the arrays fall back to DirectXMath one element at a time. A threadCount of 0 picks the thread count from the count.
+// Destinations may alias sources, but must not partially overlap them.
+namespace TransformUtil
+{
+    // whether the AVX2 kernels run on this CPU, checked once
+    bool isAvx2Supported();
+
+    // dst[i] = XMMatrixMultiply(lhs[i], rhs[i])
+    void multiplyMatrices(DirectX::XMFLOAT4X4* const dst, const DirectX::XMFLOAT4X4* const lhs, const DirectX::XMFLOAT4X4* const rhs, const size_t count, const size_t threadCount = 0u);
+
+    // dst[i] = XMMatrixMultiply(lhs[i], rhs), e.g. world matrices times a shared view projection or reflection
+    void multiplyMatrices(DirectX::XMFLOAT4X4* const dst, const DirectX::XMFLOAT4X4* const lhs, const DirectX::XMFLOAT4X4& rhs, const size_t count, const size_t threadCount = 0u);
+
+    // dst[i] = XMMatrixTranspose(XMMatrixInverse(nullptr, src[i])), which transforms normals like src[i] transforms
+    // points. Singular matrices give non-finite elements.
+    void inverseTransposeMatrices(DirectX::XMFLOAT4X4* const dst, const DirectX::XMFLOAT4X4* const src, const size_t count, const size_t threadCount = 0u);
+
+    // dst[i] = XMVector3Transform(src[i], matrix) without the w component, so affine matrices only
+    void transformPoints(DirectX::XMFLOAT3* const dst, const DirectX::XMFLOAT3* const src, const size_t count, const DirectX::XMFLOAT4X4& matrix, const size_t threadCount = 0u);
+
+    // dst[i] = XMVector3TransformNormal(src[i], matrix), pass the inverse transpose for non-uniform scales
+    void transformNormals(DirectX::XMFLOAT3* const dst, const DirectX::XMFLOAT3* const src, const size_t count, const DirectX::XMFLOAT4X4& matrix, const size_t threadCount = 0u);
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cinttypes>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Triangles adjacent to each vertex of an indexed triangle list, stored as one row per vertex, for the mesh
+// optimization, meshlet and simplification passes. Triangles can be removed as they are emitted, the live triangles of
+// a vertex stay at the front of its row. Degenerate triangles reference a vertex more than once and appear in its row
+// once per reference.
+class TriangleAdjacency
+{
+public:
+    // replaces the previous adjacency, reusing its memory, all triangles start out live
+    template <typename IndexType>
+    void build(const IndexType* const indices, const size_t indexCount, const size_t vertexCount)
+    {
+        m_offsets.assign(vertexCount + 1u, 0u);
+        for (size_t i = 0; i < indexCount; ++i)
+        {
+            ++m_offsets[indices[i] + 1u];
+        }
+        for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+        {
+            m_offsets[vertex + 1u] += m_offsets[vertex];
+        }
+
+        // the live counts double as the fill cursors of the rows and end up as the full counts
+        m_liveTriangleCounts.assign(vertexCount, 0u);
+        m_triangles.resize(indexCount);
+        for (size_t i = 0; i < indexCount; ++i)
+        {
+            m_triangles[m_offsets[indices[i]] + m_liveTriangleCounts[indices[i]]++] = static_cast<uint32_t>(i / 3u);
+        }
+    }
+
+    // the live triangles of vertex come first
+    const uint32_t* getTriangles(const size_t vertex) const { return m_triangles.data() + m_offsets[vertex]; }
+    uint32_t getTriangleCount(const size_t vertex) const { return m_offsets[vertex + 1u] - m_offsets[vertex]; }
+    uint32_t getLiveTriangleCount(const size_t vertex) const { return m_liveTriangleCounts[vertex]; }
+
+    // moves triangle behind the live triangles of each of its three vertices
+    template <typename IndexType>
+    void removeTriangle(const uint32_t triangle, const IndexType* const triangleIndices)
+    {
+        for (size_t corner = 0; corner < 3u; ++corner)
+        {
+            uint32_t* const vertexTriangles = m_triangles.data() + m_offsets[triangleIndices[corner]];
+            uint32_t& liveTriangleCount = m_liveTriangleCounts[triangleIndices[corner]];
+            for (uint32_t i = 0; i < liveTriangleCount; ++i)
+            {
+                if (vertexTriangles[i] == triangle)
+                {
+                    std::swap(vertexTriangles[i], vertexTriangles[liveTriangleCount - 1u]);
+                    --liveTriangleCount;
+                    break;
+                }
+            }
+        }
+    }
+
+private:
+    std::vector<uint32_t> m_offsets;
+    std::vector<uint32_t> m_triangles;
+    std::vector<uint32_t> m_liveTriangleCounts;
+};
\ No newline at end of file